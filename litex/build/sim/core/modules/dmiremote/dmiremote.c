@@ -0,0 +1,595 @@
+/* RISC-V Debug Module Interface (DMI) bridge for OpenOCD's jtag_vpi driver.
+ *
+ * Instead of bit-banging the CPU's JTAG TAP (jtagremote), the TAP and the RISC-V Debug Transport
+ * Module (IDCODE/DTMCS/DMI registers, debug spec 0.13) are emulated here and each DMI register
+ * update is issued as a single request on the CPU's DMI pads: a debug register access costs a few
+ * sys_clk cycles instead of ~100 JTAG shifts each processed every 10 sys_clk cycles.
+ *
+ * OpenOCD configuration:
+ *   adapter driver jtag_vpi
+ *   jtag_vpi set_port <port>
+ *   jtag newtap riscv cpu -irlen 5
+ *   target create riscv.cpu riscv -chain-position riscv.cpu
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "error.h"
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <event2/listener.h>
+#include <event2/util.h>
+#include <event2/event.h>
+
+#include <json-c/json.h>
+#include "modules.h"
+
+/* jtag_vpi protocol (OpenOCD src/jtag/drivers/jtag_vpi.c) */
+#define XFERT_MAX_SIZE          512
+#define CMD_RESET               0
+#define CMD_TMS_SEQ             1
+#define CMD_SCAN_CHAIN          2
+#define CMD_SCAN_CHAIN_FLIP_TMS 3
+#define CMD_STOP_SIMU           4
+
+struct vpi_cmd {
+  unsigned char cmd[4];
+  unsigned char buffer_out[XFERT_MAX_SIZE];
+  unsigned char buffer_in[XFERT_MAX_SIZE];
+  unsigned char length[4];
+  unsigned char nb_bits[4];
+};
+
+#define DMIREMOTE_BUF_SIZE (16*sizeof(struct vpi_cmd))
+
+/* TAP states */
+enum {
+  TAP_RESET, TAP_IDLE,
+  TAP_DRSELECT, TAP_DRCAPTURE, TAP_DRSHIFT, TAP_DREXIT1, TAP_DRPAUSE, TAP_DREXIT2, TAP_DRUPDATE,
+  TAP_IRSELECT, TAP_IRCAPTURE, TAP_IRSHIFT, TAP_IREXIT1, TAP_IRPAUSE, TAP_IREXIT2, TAP_IRUPDATE,
+};
+
+static const int tap_next[16][2] = {
+  /*                  TMS=0          TMS=1 */
+  [TAP_RESET]     = {TAP_IDLE,      TAP_RESET},
+  [TAP_IDLE]      = {TAP_IDLE,      TAP_DRSELECT},
+  [TAP_DRSELECT]  = {TAP_DRCAPTURE, TAP_IRSELECT},
+  [TAP_DRCAPTURE] = {TAP_DRSHIFT,   TAP_DREXIT1},
+  [TAP_DRSHIFT]   = {TAP_DRSHIFT,   TAP_DREXIT1},
+  [TAP_DREXIT1]   = {TAP_DRPAUSE,   TAP_DRUPDATE},
+  [TAP_DRPAUSE]   = {TAP_DRPAUSE,   TAP_DREXIT2},
+  [TAP_DREXIT2]   = {TAP_DRSHIFT,   TAP_DRUPDATE},
+  [TAP_DRUPDATE]  = {TAP_IDLE,      TAP_DRSELECT},
+  [TAP_IRSELECT]  = {TAP_IRCAPTURE, TAP_RESET},
+  [TAP_IRCAPTURE] = {TAP_IRSHIFT,   TAP_IREXIT1},
+  [TAP_IRSHIFT]   = {TAP_IRSHIFT,   TAP_IREXIT1},
+  [TAP_IREXIT1]   = {TAP_IRPAUSE,   TAP_IRUPDATE},
+  [TAP_IRPAUSE]   = {TAP_IRPAUSE,   TAP_IREXIT2},
+  [TAP_IREXIT2]   = {TAP_IRSHIFT,   TAP_IRUPDATE},
+  [TAP_IRUPDATE]  = {TAP_IDLE,      TAP_DRSELECT},
+};
+
+/* RISC-V DTM */
+#define DTM_IR_LENGTH   5
+#define DTM_IR_IDCODE   0x01
+#define DTM_IR_DTMCS    0x10
+#define DTM_IR_DMI      0x11
+#define DTM_IDCODE      0x00000db3
+#define DTM_DMI_ABITS   7
+
+#define DMI_OP_NOP      0
+#define DMI_OP_READ     1
+#define DMI_OP_WRITE    2
+#define DMI_OP_FAILED   2
+
+enum {
+  DMI_IDLE,
+  DMI_REQ,
+  DMI_RESP,
+};
+
+struct session_s {
+  char *req_valid;
+  char *req_ready;
+  char *req_addr;
+  char *req_op;
+  uint32_t *req_data;
+  char *resp_valid;
+  char *resp_ready;
+  uint32_t *resp_data;
+  char *resp_resp;
+  char *sys_clk;
+  struct event *ev;
+  int fd;
+
+  /* Received jtag_vpi data */
+  char databuf[DMIREMOTE_BUF_SIZE];
+  int data_start;
+  int datalen;
+
+  /* Current jtag_vpi command */
+  struct vpi_cmd cmd;
+  int cmd_valid;
+  unsigned int cmd_bit;
+
+  /* TAP/DTM */
+  int tap_state;
+  uint32_t ir;
+  uint32_t ir_shift;
+  uint64_t dr;
+  int dr_length;
+  uint32_t dmi_addr;
+  uint32_t dmi_data;
+  uint32_t dmi_op;
+  uint32_t dmi_status;
+  int dmi_state;
+};
+
+struct event_base *base;
+
+int litex_sim_module_get_args( char *args, char *arg, char **val)
+{
+  int ret = RC_OK;
+  json_object *jsobj = NULL;
+  json_object *obj = NULL;
+  char *value = NULL;
+  int r;
+
+  jsobj = json_tokener_parse(args);
+  if(NULL==jsobj) {
+    fprintf(stderr, "Error parsing json arg: %s \n", args);
+    ret=RC_JSERROR;
+    goto out;
+  }
+  if(!json_object_is_type(jsobj, json_type_object)) {
+    fprintf(stderr, "Arg must be type object! : %s \n", args);
+    ret=RC_JSERROR;
+    goto out;
+  }
+  obj=NULL;
+  r = json_object_object_get_ex(jsobj, arg, &obj);
+  if(!r) {
+    fprintf(stderr, "Could not find object: \"%s\" (%s)\n", arg, args);
+    ret=RC_JSERROR;
+    goto out;
+  }
+  value=strdup(json_object_get_string(obj));
+
+out:
+  *val = value;
+  return ret;
+}
+
+static int litex_sim_module_pads_get( struct pad_s *pads, char *name, void **signal)
+{
+  int ret = RC_OK;
+  void *sig = NULL;
+  int i;
+
+  if(!pads || !name || !signal) {
+    ret = RC_INVARG;
+    goto out;
+  }
+
+  i = 0;
+  while(pads[i].name) {
+    if(!strcmp(pads[i].name, name)) {
+      sig = (void*)pads[i].signal;
+      break;
+    }
+    i++;
+  }
+
+out:
+  *signal = sig;
+  return ret;
+}
+
+static uint32_t vpi_le32(const unsigned char *buf)
+{
+  return buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+/* DTM ------------------------------------------------------------------------------------------ */
+
+static void dtm_reset(struct session_s *s)
+{
+  s->ir         = DTM_IR_IDCODE;
+  s->dmi_addr   = 0;
+  s->dmi_data   = 0;
+  s->dmi_status = 0;
+}
+
+static void dtm_capture_dr(struct session_s *s)
+{
+  switch(s->ir) {
+  case DTM_IR_IDCODE:
+    s->dr        = DTM_IDCODE;
+    s->dr_length = 32;
+    break;
+  case DTM_IR_DTMCS:
+    /* version 0.13, abits, dmistat, idle: 1 cycle */
+    s->dr        = 1 | (DTM_DMI_ABITS << 4) | (s->dmi_status << 10) | (1 << 12);
+    s->dr_length = 32;
+    break;
+  case DTM_IR_DMI:
+    s->dr        = ((uint64_t)s->dmi_addr << 34) | ((uint64_t)s->dmi_data << 2) | s->dmi_status;
+    s->dr_length = DTM_DMI_ABITS + 34;
+    break;
+  default: /* BYPASS */
+    s->dr        = 0;
+    s->dr_length = 1;
+    break;
+  }
+}
+
+static void dtm_update_dr(struct session_s *s)
+{
+  uint32_t op;
+
+  switch(s->ir) {
+  case DTM_IR_DTMCS:
+    /* dmireset/dmihardreset: clear the sticky error */
+    if(s->dr & (3 << 16))
+      s->dmi_status = 0;
+    break;
+  case DTM_IR_DMI:
+    op = s->dr & 0x3;
+    if(s->dmi_status || ((op != DMI_OP_READ) && (op != DMI_OP_WRITE)))
+      break;
+    s->dmi_addr  = (s->dr >> 34) & ((1 << DTM_DMI_ABITS) - 1);
+    s->dmi_data  = (s->dr >> 2) & 0xffffffff;
+    s->dmi_op    = op;
+    s->dmi_state = DMI_REQ;
+    break;
+  default:
+    break;
+  }
+}
+
+/* One TCK cycle, returns TDO */
+static int tap_clock(struct session_s *s, int tms, int tdi)
+{
+  int tdo = 0;
+
+  if(s->tap_state == TAP_DRSHIFT) {
+    tdo   = s->dr & 1;
+    s->dr = (s->dr >> 1) | ((uint64_t)tdi << (s->dr_length - 1));
+  } else if(s->tap_state == TAP_IRSHIFT) {
+    tdo         = s->ir_shift & 1;
+    s->ir_shift = (s->ir_shift >> 1) | (tdi << (DTM_IR_LENGTH - 1));
+  }
+
+  s->tap_state = tap_next[s->tap_state][tms];
+  switch(s->tap_state) {
+  case TAP_RESET:
+    dtm_reset(s);
+    break;
+  case TAP_DRCAPTURE:
+    dtm_capture_dr(s);
+    break;
+  case TAP_DRUPDATE:
+    dtm_update_dr(s);
+    break;
+  case TAP_IRCAPTURE:
+    s->ir_shift = 0x01;
+    break;
+  case TAP_IRUPDATE:
+    s->ir = s->ir_shift;
+    break;
+  default:
+    break;
+  }
+  return tdo;
+}
+
+/* jtag_vpi ------------------------------------------------------------------------------------- */
+
+static void dmiremote_close_conn(struct session_s *s)
+{
+  if(s->ev) {
+    event_free(s->ev);
+    s->ev = NULL;
+  }
+  if(s->fd) {
+    close(s->fd);
+    s->fd = 0;
+  }
+  s->datalen   = 0;
+  s->cmd_valid = 0;
+}
+
+static int dmiremote_send(struct session_s *s, const void *buf, size_t len)
+{
+  const char *p = buf;
+  ssize_t n;
+
+  while(len) {
+    n = write(s->fd, p, len);
+    if(n < 0) {
+      if((errno == EAGAIN) || (errno == EWOULDBLOCK))
+        continue;
+      return RC_ERROR;
+    }
+    p   += n;
+    len -= n;
+  }
+  return RC_OK;
+}
+
+/* Process the current command, returns when done or when waiting for a DMI access */
+static int dmiremote_process_cmd(struct session_s *s)
+{
+  uint32_t cmd     = vpi_le32(s->cmd.cmd);
+  uint32_t nb_bits = vpi_le32(s->cmd.nb_bits);
+  int tms, tdi, tdo;
+
+  if(nb_bits > 8*XFERT_MAX_SIZE)
+    nb_bits = 8*XFERT_MAX_SIZE;
+
+  switch(cmd) {
+  case CMD_RESET:
+    s->tap_state = TAP_RESET;
+    dtm_reset(s);
+    break;
+  case CMD_TMS_SEQ:
+  case CMD_SCAN_CHAIN:
+  case CMD_SCAN_CHAIN_FLIP_TMS:
+    while(s->cmd_bit < nb_bits) {
+      if(cmd == CMD_TMS_SEQ) {
+        tms = (s->cmd.buffer_out[s->cmd_bit/8] >> (s->cmd_bit%8)) & 1;
+        tdi = 0;
+      } else {
+        tms = (cmd == CMD_SCAN_CHAIN_FLIP_TMS) && (s->cmd_bit == nb_bits - 1);
+        tdi = (s->cmd.buffer_out[s->cmd_bit/8] >> (s->cmd_bit%8)) & 1;
+      }
+      tdo = tap_clock(s, tms, tdi);
+      if(tdo)
+        s->cmd.buffer_in[s->cmd_bit/8] |=  (1 << (s->cmd_bit%8));
+      else
+        s->cmd.buffer_in[s->cmd_bit/8] &= ~(1 << (s->cmd_bit%8));
+      s->cmd_bit++;
+      /* Wait for the DMI access before shifting further */
+      if(s->dmi_state != DMI_IDLE)
+        return RC_OK;
+    }
+    if(cmd != CMD_TMS_SEQ) {
+      if(dmiremote_send(s, &s->cmd, sizeof(s->cmd)) != RC_OK) {
+        eprintf("Error writing on socket\n");
+        return RC_ERROR;
+      }
+    }
+    break;
+  case CMD_STOP_SIMU:
+    printf("[dmiremote] client disconnected\n");
+    s->cmd_valid = 0;
+    dmiremote_close_conn(s);
+    return RC_OK;
+  default:
+    break;
+  }
+  s->cmd_valid = 0;
+  return RC_OK;
+}
+
+static int dmiremote_start(void *b)
+{
+  base = (struct event_base *)b;
+  printf("[dmiremote] loaded (%p)\n", base);
+  return RC_OK;
+}
+
+void read_handler(int fd, short event, void *arg)
+{
+  struct session_s *s = (struct session_s*)arg;
+  char buffer[1024];
+  ssize_t read_len;
+  size_t free_len;
+  int i;
+
+  /* Stop reading when full, re-enabled from the tick */
+  free_len = DMIREMOTE_BUF_SIZE - s->datalen;
+  if(free_len == 0) {
+    event_del(s->ev);
+    return;
+  }
+
+  read_len = read(fd, buffer, (free_len < sizeof(buffer)) ? free_len : sizeof(buffer));
+  if(read_len <= 0) {
+    if((read_len == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK)))
+      dmiremote_close_conn(s);
+    return;
+  }
+  for(i = 0; i < read_len; i++)
+  {
+    s->databuf[(s->data_start +  s->datalen ) % DMIREMOTE_BUF_SIZE] = buffer[i];
+    s->datalen++;
+  }
+}
+
+static void event_handler(int fd, short event, void *arg)
+{
+  if (event & EV_READ)
+    read_handler(fd, event, arg);
+}
+
+static void accept_conn_cb(struct evconnlistener *listener, evutil_socket_t fd, struct sockaddr *address, int socklen,  void *ctx)
+{
+  struct session_s *s = (struct session_s*)ctx;
+  int one = 1;
+
+  if(s->fd) {
+    close(fd);
+    return;
+  }
+  /* Scan replies are on the critical path of each DMI access */
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  s->fd = fd;
+  s->ev = event_new(base, fd, EV_READ | EV_PERSIST , event_handler, s);
+  event_add(s->ev, NULL);
+}
+
+static void
+accept_error_cb(struct evconnlistener *listener, void *ctx)
+{
+  struct event_base *base = evconnlistener_get_base(listener);
+  eprintf("ERRROR\n");
+
+  event_base_loopexit(base, NULL);
+}
+
+static int dmiremote_new(void **sess, char *args)
+{
+  int ret = RC_OK;
+  struct session_s *s = NULL;
+  char *cport = NULL;
+  int port;
+  struct evconnlistener *listener;
+  struct sockaddr_in sin;
+
+  if(!sess) {
+    ret = RC_INVARG;
+    goto out;
+  }
+
+  ret = litex_sim_module_get_args(args, "port", &cport);
+  if(RC_OK != ret)
+    goto out;
+
+  printf("Found port %s\n", cport);
+  sscanf(cport, "%d", &port);
+  free(cport);
+  if(!port) {
+    ret = RC_ERROR;
+    fprintf(stderr, "Invalid port selected!\n");
+    goto out;
+  }
+
+  s=(struct session_s*)malloc(sizeof(struct session_s));
+  if(!s) {
+    ret = RC_NOENMEM;
+    goto out;
+  }
+  memset(s, 0, sizeof(struct session_s));
+  s->tap_state = TAP_RESET;
+  dtm_reset(s);
+
+  memset(&sin, 0, sizeof(sin));
+  sin.sin_family = AF_INET;
+  sin.sin_addr.s_addr = htonl(0);
+  sin.sin_port = htons(port);
+  listener = evconnlistener_new_bind(base, accept_conn_cb, s,  LEV_OPT_CLOSE_ON_FREE|LEV_OPT_REUSEABLE, -1, (struct sockaddr*)&sin, sizeof(sin));
+  if (!listener) {
+    ret=RC_ERROR;
+    eprintf("Can't bind port %d\n!\n", port);
+    goto out;
+  }
+  evconnlistener_set_error_cb(listener, accept_error_cb);
+
+out:
+  *sess=(void*)s;
+  return ret;
+}
+
+static int dmiremote_add_pads(void *sess, struct pad_list_s *plist)
+{
+  int ret=RC_OK;
+  struct session_s *s=(struct session_s*)sess;
+  struct pad_s *pads;
+  if(!sess || !plist) {
+    ret = RC_INVARG;
+    goto out;
+  }
+  pads = plist->pads;
+  if(!strcmp(plist->name, "dmi")) {
+    litex_sim_module_pads_get(pads, "req_valid",  (void**)&s->req_valid);
+    litex_sim_module_pads_get(pads, "req_ready",  (void**)&s->req_ready);
+    litex_sim_module_pads_get(pads, "req_addr",   (void**)&s->req_addr);
+    litex_sim_module_pads_get(pads, "req_op",     (void**)&s->req_op);
+    litex_sim_module_pads_get(pads, "req_data",   (void**)&s->req_data);
+    litex_sim_module_pads_get(pads, "resp_valid", (void**)&s->resp_valid);
+    litex_sim_module_pads_get(pads, "resp_ready", (void**)&s->resp_ready);
+    litex_sim_module_pads_get(pads, "resp_data",  (void**)&s->resp_data);
+    litex_sim_module_pads_get(pads, "resp_resp",  (void**)&s->resp_resp);
+  }
+
+  if(!strcmp(plist->name, "sys_clk"))
+    litex_sim_module_pads_get(pads, "sys_clk", (void**)&s->sys_clk);
+
+out:
+  return ret;
+
+}
+
+static int dmiremote_tick(void *sess, uint64_t time_ps)
+{
+  static clk_edge_state_t edge;
+  int ret = RC_OK;
+  int i;
+
+  struct session_s *s = (struct session_s*)sess;
+  if(!clk_pos_edge(&edge, *s->sys_clk)) {
+    return RC_OK;
+  }
+
+  /* DMI response */
+  *s->resp_ready = 1;
+  if((s->dmi_state == DMI_RESP) && *s->resp_valid) {
+    if(*s->resp_resp)
+      s->dmi_status = DMI_OP_FAILED;
+    else if(s->dmi_op == DMI_OP_READ)
+      s->dmi_data = *s->resp_data;
+    s->dmi_state = DMI_IDLE;
+  }
+
+  /* DMI request */
+  *s->req_valid = 0;
+  if(s->dmi_state == DMI_REQ) {
+    *s->req_valid = 1;
+    *s->req_addr  = s->dmi_addr;
+    *s->req_op    = s->dmi_op;
+    *s->req_data  = s->dmi_data;
+    if(*s->req_ready)
+      s->dmi_state = DMI_RESP;
+  }
+  if(s->dmi_state != DMI_IDLE)
+    return RC_OK;
+
+  /* Get next jtag_vpi command */
+  if(!s->cmd_valid && (s->datalen >= sizeof(struct vpi_cmd))) {
+    for(i = 0; i < sizeof(struct vpi_cmd); i++) {
+      ((char *)&s->cmd)[i] = s->databuf[s->data_start];
+      s->data_start = (s->data_start + 1) % DMIREMOTE_BUF_SIZE;
+    }
+    if(s->datalen == DMIREMOTE_BUF_SIZE)
+      event_add(s->ev, NULL);
+    s->datalen  -= sizeof(struct vpi_cmd);
+    s->cmd_valid = 1;
+    s->cmd_bit   = 0;
+  }
+
+  /* Process it */
+  if(s->cmd_valid)
+    ret = dmiremote_process_cmd(s);
+
+  return ret;
+}
+
+static struct ext_module_s ext_mod = {
+  "dmiremote",
+  dmiremote_start,
+  dmiremote_new,
+  dmiremote_add_pads,
+  NULL,
+  dmiremote_tick
+};
+
+int litex_sim_ext_module_init(int (*register_module)(struct ext_module_s *))
+{
+  int ret = RC_OK;
+  ret = register_module(&ext_mod);
+  return ret;
+}
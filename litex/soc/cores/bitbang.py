@@ -7,6 +7,7 @@
 
 from migen import *
 from migen.fhdl.specials import Tristate
+from migen.genlib.cdc import MultiReg
 
 from litex.gen import *
 
@@ -27,13 +28,15 @@ class I2CMaster(LiteXModule):
     """
     pads_layout = [("scl", 1), ("sda", 1)]
 
-    def __init__(self, pads=None, default_dev=False):
+    def __init__(self, pads=None, default_dev=False, with_controller=False):
         """
         Class constructor.
 
-        :param pads        : (optional) A ``Record`` object containing the pads ``scl`` and ``sda``.
-        :param default_dev : (optional) A `bool` indicating whether this I2C master should be used as
-                             the default I2C interface (default is ``False``).
+        :param pads            : (optional) A ``Record`` object containing the pads ``scl`` and ``sda``.
+        :param default_dev     : (optional) A `bool` indicating whether this I2C master should be used as
+                                 the default I2C interface (default is ``False``).
+        :param with_controller : (optional) A `bool` indicating whether to add the byte-level hardware
+                                 controller (see ``add_controller``, default is ``False``).
         """
         self.init = []
         if pads is None:
@@ -50,8 +53,186 @@ class I2CMaster(LiteXModule):
 
         self.default_dev = default_dev
 
+        # Lines state (from the bit-banging register or the controller).
+        self.scl = Signal()
+        self.oe  = Signal()
+        self.sda = Signal()
+        if with_controller:
+            self.add_controller()
+        else:
+            self.comb += [
+                self.scl.eq(self._w.fields.scl),
+                self.oe.eq( self._w.fields.oe),
+                self.sda.eq(self._w.fields.sda),
+            ]
+
         self.connect(pads)
 
+    def add_controller(self):
+        """
+        Adds a byte-level I2C controller: each write of the ``cmd`` register generates an optional
+        (repeated) START condition, transmits or receives a byte with its ACK bit and generates an
+        optional STOP condition, with the SCL timing derived from ``clkdiv``. The controller drives
+        the lines from a command write until the next write of the bit-banging register (used by
+        software for bus recovery), so both interfaces can be mixed.
+        """
+        self._clkdiv = CSRStorage(16, reset=249, description="SCL quarter period in sys_clk cycles minus 1.")
+        self._cmd = CSRStorage(fields=[
+            CSRField("data",  size=8, offset=0,  description="Byte to transmit (``write``)."),
+            CSRField("start", size=1, offset=8,  description="Generate a (repeated) START condition first."),
+            CSRField("write", size=1, offset=9,  description="Transmit ``data`` and receive the ACK bit."),
+            CSRField("read",  size=1, offset=10, description="Receive a byte and transmit the ACK bit."),
+            CSRField("ack",   size=1, offset=11, description="ACK the received byte (``read``)."),
+            CSRField("stop",  size=1, offset=12, description="Generate a STOP condition last.")],
+            description="Controller command, executed on write.",
+            name="cmd")
+        self._status = CSRStatus(fields=[
+            CSRField("data", size=8, offset=0, description="Received byte (``read``)."),
+            CSRField("busy", size=1, offset=8, description="Command in progress."),
+            CSRField("nack", size=1, offset=9, description="Slave did not ACK the transmitted byte (``write``).")],
+            name="status")
+
+        # # #
+
+        sel   = Signal()
+        scl   = Signal(reset=1)
+        oe    = Signal()
+        sda   = Signal(reset=1)
+        scl_n = Signal()
+        oe_n  = Signal()
+        sda_n = Signal()
+        sda_i = Signal()
+        cmd   = Signal(len(self._cmd.storage))
+        shift = Signal(8)
+        nack  = Signal()
+        count = Signal(16)
+        tick  = Signal()
+        phase = Signal(2)
+        bit   = Signal(4)
+
+        self.specials += MultiReg(self._r.fields.sda, sda_i)
+
+        # Lines selection: controller from a command write to a bit-banging write.
+        self.sync += [
+            If(self._cmd.re,
+                sel.eq(1)
+            ).Elif(self._w.re,
+                sel.eq(0)
+            ),
+            scl.eq(scl_n),
+            oe.eq(oe_n),
+            sda.eq(sda_n),
+        ]
+        self.comb += [
+            If(sel,
+                self.scl.eq(scl),
+                self.oe.eq(oe),
+                self.sda.eq(sda),
+            ).Else(
+                self.scl.eq(self._w.fields.scl),
+                self.oe.eq( self._w.fields.oe),
+                self.sda.eq(self._w.fields.sda),
+            ),
+            self._status.fields.data.eq(shift),
+            self._status.fields.nack.eq(nack),
+        ]
+
+        # Each START/bit/STOP is 4 phases of a quarter SCL period, lines updated at phase start.
+        self.fsm = fsm = FSM(reset_state="IDLE")
+        self.sync += [
+            If(fsm.ongoing("IDLE") | tick,
+                count.eq(self._clkdiv.storage)
+            ).Else(
+                count.eq(count - 1)
+            ),
+            If(tick,
+                phase.eq(phase + 1)
+            ),
+        ]
+        self.comb += tick.eq(~fsm.ongoing("IDLE") & (count == 0))
+        self.comb += self._status.fields.busy.eq(~fsm.ongoing("IDLE"))
+
+        cmd_write = cmd[9]
+        cmd_read  = cmd[10]
+        cmd_ack   = cmd[11]
+        cmd_stop  = cmd[12]
+
+        # Byte done: STOP or back to IDLE (SCL kept low between bytes).
+        def next_after_byte():
+            return If(cmd_stop, NextState("STOP")).Else(NextState("IDLE"))
+
+        fsm.act("IDLE",
+            scl_n.eq(scl),
+            oe_n.eq(0),
+            sda_n.eq(1),
+            If(self._cmd.re,
+                NextValue(cmd, self._cmd.storage),
+                NextValue(shift, self._cmd.fields.data),
+                NextValue(phase, 0),
+                NextValue(bit,   0),
+                NextValue(nack,  0),
+                If(self._cmd.fields.start,
+                    NextState("START")
+                ).Elif(self._cmd.fields.write | self._cmd.fields.read,
+                    NextState("BIT")
+                ).Elif(self._cmd.fields.stop,
+                    NextState("STOP")
+                )
+            )
+        )
+        fsm.act("START",
+            # SDA high (SCL unchanged), SCL high, SDA low, SCL low.
+            oe_n.eq(1),
+            Case(phase, {
+                0: [scl_n.eq(scl), sda_n.eq(1)],
+                1: [scl_n.eq(1),   sda_n.eq(1)],
+                2: [scl_n.eq(1),   sda_n.eq(0)],
+                3: [scl_n.eq(0),   sda_n.eq(0)],
+            }),
+            If(tick & (phase == 3),
+                If(cmd_write | cmd_read,
+                    NextState("BIT")
+                ).Elif(cmd_stop,
+                    NextState("STOP")
+                ).Else(
+                    NextState("IDLE")
+                )
+            )
+        )
+        # 8 data bits (MSB first) then the ACK bit; SCL high on phases 1-2, sampled at end of phase 1.
+        tx = Signal()
+        self.comb += tx.eq(Mux(bit == 8, cmd_read, cmd_write))
+        fsm.act("BIT",
+            scl_n.eq((phase == 1) | (phase == 2)),
+            oe_n.eq(tx),
+            sda_n.eq(Mux(cmd_write, shift[7], ~cmd_ack) | ~tx),
+            If(tick & (phase == 1) & ~tx,
+                If(bit == 8,
+                    NextValue(nack, sda_i)
+                ).Else(
+                    NextValue(shift, Cat(sda_i, shift[:7]))
+                )
+            ),
+            If(tick & (phase == 3),
+                NextValue(bit, bit + 1),
+                If(cmd_write & (bit != 8),
+                    NextValue(shift, shift << 1)
+                ),
+                If(bit == 8,
+                    next_after_byte()
+                )
+            )
+        )
+        fsm.act("STOP",
+            # SCL low/SDA low, SCL high, SDA high, lines released.
+            oe_n.eq(phase != 3),
+            scl_n.eq(phase != 0),
+            sda_n.eq(phase[1]),
+            If(tick & (phase == 3),
+                NextState("IDLE")
+            )
+        )
+
     def connect(self, pads):
         """
         Attaches the signals from inside the core to the input/output pads. This function is normally
@@ -61,13 +242,13 @@ class I2CMaster(LiteXModule):
         """
         # SCL
         self.specials += Tristate(pads.scl,
-            o  = 0,                  # I2C uses Pull-ups, only drive low.
-            oe = ~self._w.fields.scl # Drive when scl is low.
+            o  = 0,         # I2C uses Pull-ups, only drive low.
+            oe = ~self.scl  # Drive when scl is low.
         )
         # SDA
         self.specials += Tristate(pads.sda,
-            o  = 0,                                       # I2C uses Pull-ups, only drive low.
-            oe = self._w.fields.oe & ~self._w.fields.sda, # Drive when oe and sda is low.
+            o  = 0,                     # I2C uses Pull-ups, only drive low.
+            oe = self.oe & ~self.sda,   # Drive when oe and sda is low.
             i  = self._r.fields.sda
         )
 
@@ -106,9 +287,9 @@ class I2CMasterSim(I2CMaster):
         _sda_in = Signal()
 
         self.comb += [
-            pads.scl.eq(self._w.fields.scl),
-            _sda_oe.eq( self._w.fields.oe),
-            _sda_w.eq(  self._w.fields.sda),
+            pads.scl.eq(self.scl),
+            _sda_oe.eq( self.oe),
+            _sda_w.eq(  self.sda),
             If(_sda_oe,
                 pads.sda_out.eq(_sda_w),
                 self._r.fields.sda.eq(_sda_w),
@@ -207,6 +207,21 @@ class CVA6(CPU):
             o_tdo    = self.jtag_tdo,
         )
 
+    def add_dmi(self, pads):
+        # Direct access to the Debug Module Interface (bypasses the JTAG DTM, ex for simulation).
+        self.cpu_params.update(
+            p_DmiJtag          = 0,
+            i_dmi_req_valid_i  = pads.req_valid,
+            o_dmi_req_ready_o  = pads.req_ready,
+            i_dmi_req_addr_i   = pads.req_addr,
+            i_dmi_req_op_i     = pads.req_op,
+            i_dmi_req_data_i   = pads.req_data,
+            o_dmi_resp_valid_o = pads.resp_valid,
+            i_dmi_resp_ready_i = pads.resp_ready,
+            o_dmi_resp_data_o  = pads.resp_data,
+            o_dmi_resp_resp_o  = pads.resp_resp,
+        )
+
     def set_reset_address(self, reset_address):
         self.reset_address = reset_address
         assert reset_address == 0x1000_0000, "cpu_reset_addr hardcoded in during elaboration!"
@@ -215,4 +230,6 @@ class CVA6(CPU):
         assert hasattr(self, "reset_address")
         if "i_trst_n" not in self.cpu_params:
             self.cpu_params["i_trst_n"] = 1
+        if "i_dmi_req_valid_i" not in self.cpu_params:
+            self.cpu_params.update(i_dmi_req_valid_i=0, i_dmi_resp_ready_i=0)
         self.specials += Instance("cva6_wrapper", **self.cpu_params)
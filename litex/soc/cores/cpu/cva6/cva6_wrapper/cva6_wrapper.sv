@@ -5,7 +5,11 @@
 
 import cva6_wrapper_pkg::*;
 
-module cva6_wrapper (
+module cva6_wrapper #(
+    // 1: Debug Module accessed through the JTAG DTM (tck/tms/tdi/tdo).
+    // 0: Debug Module accessed directly through the dmi_* ports (ex for simulation).
+    parameter bit DmiJtag = 1'b1
+) (
     input  logic         clk_i   ,
     input  logic         rst_n  ,
 
@@ -77,7 +81,18 @@ module cva6_wrapper (
     input  logic        tms         ,
     input  logic        tdi         ,
     output wire         tdo         ,
-    output wire         tdo_oe         
+    output wire         tdo_oe      ,
+
+    // Direct DMI access (DmiJtag = 0)
+    input  logic        dmi_req_valid_i  ,
+    output logic        dmi_req_ready_o  ,
+    input  logic [ 6:0] dmi_req_addr_i   ,
+    input  logic [ 1:0] dmi_req_op_i     ,
+    input  logic [31:0] dmi_req_data_i   ,
+    output logic        dmi_resp_valid_o ,
+    input  logic        dmi_resp_ready_i ,
+    output logic [31:0] dmi_resp_data_o  ,
+    output logic [ 1:0] dmi_resp_resp_o
 );
 
 `AXI_TYPEDEF_ALL(axi_slave,
@@ -188,6 +203,8 @@ axi_xbar_intf #(
 // ---------------
 // Debug Module
 // ---------------
+generate
+if (DmiJtag) begin : gen_dmi_jtag
 dmi_jtag i_dmi_jtag (
     .clk_i                ( clk_i                ),
     .rst_ni               ( rst_n                ),
@@ -207,6 +224,26 @@ dmi_jtag i_dmi_jtag (
     .tdo_oe_o             ( tdo_oe )
 );
 
+assign dmi_req_ready_o  = 1'b0;
+assign dmi_resp_valid_o = 1'b0;
+assign dmi_resp_data_o  = '0;
+assign dmi_resp_resp_o  = '0;
+end else begin : gen_dmi_ports
+assign debug_req_valid  = dmi_req_valid_i;
+assign debug_req.addr   = dmi_req_addr_i;
+assign debug_req.op     = dm::dtm_op_e'(dmi_req_op_i);
+assign debug_req.data   = dmi_req_data_i;
+assign dmi_req_ready_o  = debug_req_ready;
+assign dmi_resp_valid_o = debug_resp_valid;
+assign debug_resp_ready = dmi_resp_ready_i;
+assign dmi_resp_data_o  = debug_resp.data;
+assign dmi_resp_resp_o  = debug_resp.resp;
+
+assign tdo    = 1'b0;
+assign tdo_oe = 1'b0;
+end
+endgenerate
+
 ariane_axi::req_t    dm_axi_m_req;
 ariane_axi::resp_t   dm_axi_m_resp;
 
@@ -0,0 +1,123 @@
+#
+# This file is part of LiteX.
+#
+# SPDX-License-Identifier: BSD-2-Clause
+
+"""CRC32 (zlib/Ethernet) accelerator, fed by CPU word writes or by a DMA reader."""
+
+from migen import *
+
+from litex.gen import *
+from litex.gen.common import reverse_bytes
+
+from litex.soc.interconnect.csr import *
+from litex.soc.interconnect import wishbone
+from litex.soc.cores.dma import WishboneDMAReader
+
+# CRC32 Engine -------------------------------------------------------------------------------------
+
+class CRC32Engine(LiteXModule):
+    """Parallel CRC32 engine.
+
+    Updates crc_prev with the bytes of data (first byte in the MSBs, each byte processed LSB first,
+    reflected polynomial 0xedb88320) in a single cycle. The state is not inverted: start from
+    0xffffffff and invert the final value to get the zlib/Ethernet CRC32.
+    """
+    polynom = 0xedb88320
+
+    def __init__(self, data_width=32):
+        assert data_width % 8 == 0
+        self.data     = Signal(data_width)
+        self.crc_prev = Signal(32)
+        self.crc_next = Signal(32)
+
+        # # #
+
+        # Compute the XOR equations of crc_next (as sets of crc_prev/data bits) by unrolling the
+        # serial LFSR over the data bits.
+        state = [{("crc", i)} for i in range(32)]
+        for byte in range(data_width//8):
+            for bit in range(8):
+                feedback = state[0] ^ {("data", data_width - 8*(byte + 1) + bit)}
+                state    = state[1:] + [set()]
+                for i in range(32):
+                    if (self.polynom >> i) & 0b1:
+                        state[i] = state[i] ^ feedback
+
+        # Generate the XOR trees.
+        for i in range(32):
+            terms = [getattr(self, {"crc": "crc_prev", "data": "data"}[s])[n] for s, n in sorted(state[i])]
+            self.comb += self.crc_next[i].eq(Reduce("XOR", terms))
+
+# CRC32 --------------------------------------------------------------------------------------------
+
+class CRC32(LiteXModule):
+    """CRC32 accelerator.
+
+    The CRC state is initialized with ``init`` and updated with each 32-bit word written to
+    ``data`` (as seen by the CPU, so a word loaded from memory is processed in memory byte order)
+    or read from memory by the optional DMA reader. ``value`` returns the (non-inverted) state,
+    which allows software to handle unaligned heads/tails and to continue a computation.
+
+    Parameters
+    ----------
+    bus : wishbone.Interface
+        Optional 32-bit bus for the DMA reader.
+
+    endianness : str
+        CPU endianness.
+    """
+    def __init__(self, bus=None, endianness="little"):
+        self.engine = engine = CRC32Engine(data_width=32)
+
+        self._init  = CSRStorage(32, reset=0xffffffff, description="CRC state initialization.")
+        self._data  = CSRStorage(32, reset_less=True,  description="Data word to process.")
+        self._value = CSRStatus(32,                    description="CRC state (invert it to get the CRC32).")
+
+        # # #
+
+        crc   = Signal(32, reset=0xffffffff)
+        data  = Signal(32)
+        valid = Signal()
+        self.comb += [
+            engine.crc_prev.eq(crc),
+            engine.data.eq(data),
+            self._value.status.eq(crc),
+        ]
+        self.sync += [
+            If(self._init.re,
+                crc.eq(self._init.storage)
+            ).Elif(valid,
+                crc.eq(engine.crc_next)
+            )
+        ]
+
+        # CPU word writes (memory byte order: first byte in the MSBs for the engine).
+        cpu_data = {"little": reverse_bytes(self._data.storage), "big": self._data.storage}[endianness]
+        self.comb += [
+            valid.eq(self._data.re),
+            data.eq(cpu_data),
+        ]
+
+        # DMA reader.
+        if bus is not None:
+            assert bus.data_width == 32
+            self.dma = dma = WishboneDMAReader(bus, endianness=endianness)
+            dma.add_ctrl()
+            self._dma_base   = CSRStorage(64, description="DMA base address (in bytes, word aligned).")
+            self._dma_length = CSRStorage(32, description="DMA length (in bytes, multiple of 4).")
+            self._dma_enable = CSRStorage(description="DMA enable (Write ``1`` to start, ``0`` to reset).")
+            self._dma_done   = CSRStatus(description="DMA done (all words processed).")
+            self.comb += [
+                dma.base.eq(self._dma_base.storage),
+                dma.length.eq(self._dma_length.storage),
+                dma.enable.eq(self._dma_enable.storage),
+                # The engine processes a word per cycle.
+                dma.source.ready.eq(1),
+                If(dma.source.valid,
+                    valid.eq(1),
+                    data.eq(dma.source.data),
+                ),
+                # Done when the reader has issued all reads and its FIFO is empty.
+                self._dma_done.status.eq(dma.done & ~dma.source.valid),
+            ]
@@ -12,6 +12,7 @@ from litex.gen import *
 from litex.gen.common import reverse_bytes
 
 from litex.soc.interconnect.csr import *
+from litex.soc.interconnect.csr_eventmanager import *
 from litex.soc.interconnect import stream
 from litex.soc.interconnect import wishbone
 
@@ -246,3 +247,133 @@ class WishboneDMAWriter(LiteXModule):
             self._done.status.eq(self.done),
             self._offset.status.eq(self.offset),
         ]
+
+# WishboneDMACopy ----------------------------------------------------------------------------------
+
+class WishboneDMACopy(LiteXModule):
+    """Memory to memory copy/fill engine.
+
+    Chains a WishboneDMAReader and a WishboneDMAWriter (each with its own bus master) through the
+    reader's FIFO: the reader prefetches up to fifo_depth words while the writer is stalled. In
+    fill mode, the reader is idle and the writer stores the (replicated) 32-bit value.
+
+    Addresses and length are in bytes and must be aligned on the bus data width (the firmware
+    handles unaligned heads/tails with the CPU). Data is passed as-is from the read to the write
+    bus, so the copy is independent of the CPU endianness.
+
+    Parameters
+    ----------
+    bus_r : wishbone.Interface
+        Bus to read from.
+
+    bus_w : wishbone.Interface
+        Bus to write to.
+
+    fifo_depth : int
+        Read FIFO depth (in words).
+    """
+    def __init__(self, bus_r, bus_w, fifo_depth=16, with_csr=True, with_irq=True):
+        assert bus_r.data_width == bus_w.data_width
+        assert bus_r.data_width % 32 == 0
+        self.bus_r = bus_r
+        self.bus_w = bus_w
+
+        self.src    = Signal(64)
+        self.dst    = Signal(64)
+        self.length = Signal(32)
+        self.value  = Signal(32)
+        self.fill   = Signal()
+        self.start  = Signal()
+        self.done   = Signal()
+        self.offset = Signal(32)
+        self.irq    = Signal()
+
+        # # #
+
+        shift = log2_int(bus_w.data_width//8)
+
+        # Reader/Writer (no byte swapping: data is only moved).
+        self.reader = reader = WishboneDMAReader(bus_r, endianness="big", fifo_depth=fifo_depth)
+        self.writer = writer = WishboneDMAWriter(bus_w, endianness="big")
+        reader.add_ctrl()
+        writer.add_ctrl(ready_on_idle=0)
+        enable = Signal()
+        self.comb += [
+            reader.base.eq(self.src),
+            reader.length.eq(self.length),
+            reader.enable.eq(enable & ~self.fill),
+            writer.base.eq(self.dst),
+            writer.length.eq(self.length),
+            writer.enable.eq(enable),
+            self.offset.eq(writer.offset << shift),
+        ]
+
+        # Reader -> Writer (Copy) / Value -> Writer (Fill).
+        self.comb += [
+            If(self.fill,
+                writer.sink.valid.eq(1),
+                writer.sink.data.eq(Replicate(self.value, bus_w.data_width//32)),
+            ).Else(
+                reader.source.connect(writer.sink),
+            )
+        ]
+
+        # Control.
+        self.fsm = fsm = FSM(reset_state="IDLE")
+        fsm.act("IDLE",
+            self.done.eq(1),
+            If(self.start & (self.length[shift:] != 0),
+                NextState("RUN")
+            )
+        )
+        fsm.act("RUN",
+            enable.eq(1),
+            If(writer.done,
+                self.irq.eq(1),
+                NextState("IDLE")
+            )
+        )
+
+        # CSRs.
+        if with_csr:
+            self.add_csr()
+
+        # IRQ.
+        if with_irq:
+            self.ev      = EventManager()
+            self.ev.done = EventSourcePulse(description="DMA Copy/Fill terminated.")
+            self.ev.finalize()
+            self.comb += self.ev.done.trigger.eq(self.irq)
+
+    def add_csr(self):
+        adr_width = max(len(self.bus_r.adr), len(self.bus_w.adr)) + log2_int(self.bus_w.data_width//8)
+        self._src     = CSRStorage(min(adr_width, 64), description="Source address (in bytes).")
+        self._dst     = CSRStorage(min(adr_width, 64), description="Destination address (in bytes).")
+        self._length  = CSRStorage(32, description="Length (in bytes).")
+        self._value   = CSRStorage(32, description="Fill value.")
+        self._control = CSRStorage(description="DMA Copy Control.", fields=[
+            CSRField("start", size=1, offset=0, pulse=True, description="Start (Write ``1`` to start transfer)."),
+            CSRField("fill",  size=1, offset=1, values=[
+                ("``0b0``", "Copy: ``length`` bytes from ``src`` to ``dst``."),
+                ("``0b1``", "Fill: ``length`` bytes of ``dst`` with ``value``."),
+            ]),
+        ])
+        self._status  = CSRStatus(description="DMA Copy Status.", fields=[
+            CSRField("done", size=1, offset=0, description="Transfer done/idle (when read as ``1``)."),
+        ])
+        self._offset  = CSRStatus(32, description="Bytes written by the current transfer.")
+
+        # # #
+
+        self.comb += [
+            # Control.
+            self.src.eq(self._src.storage),
+            self.dst.eq(self._dst.storage),
+            self.length.eq(self._length.storage),
+            self.value.eq(self._value.storage),
+            self.start.eq(self._control.fields.start),
+            self.fill.eq(self._control.fields.fill),
+            # Status.
+            self._status.fields.done.eq(self.done),
+            self._offset.status.eq(self.offset),
+        ]
@@ -202,14 +202,14 @@ def _get_uart_fifo(depth, sink_cd="sys", source_cd="sys"):
     else:
         return stream.SyncFIFO([("data", 8)], depth, buffered=True)
 
-def UARTPHY(pads, clk_freq, baudrate):
+def UARTPHY(pads, clk_freq, baudrate, with_dynamic_baudrate=False):
     # FT245 Asynchronous FIFO mode (baudrate ignored)
     if hasattr(pads, "rd_n") and hasattr(pads, "wr_n"):
         from litex.soc.cores.usb_fifo import FT245PHYAsynchronous
         return FT245PHYAsynchronous(pads, clk_freq)
     # RS232
     else:
-        return  RS232PHY(pads, clk_freq, baudrate)
+        return  RS232PHY(pads, clk_freq, baudrate, with_dynamic_baudrate)
 
 class UART(LiteXModule, UARTInterface):
     def __init__(self, phy=None,
@@ -431,18 +431,31 @@ class Stream2Wishbone(LiteXModule):
 
 
 class UARTBone(Stream2Wishbone):
-    def __init__(self, phy, clk_freq, cd="sys", address_width=32):
+    """Stream2Wishbone over a UART PHY.
+
+    The RX FIFO (rx_fifo_depth bytes) buffers the commands received while read data is being
+    sent, allowing the host to pipeline read commands (CommUART pipeline).
+    """
+    def __init__(self, phy, clk_freq, cd="sys", address_width=32, rx_fifo_depth=16):
         if cd == "sys":
             self.phy = phy
-            Stream2Wishbone.__init__(self, self.phy, clk_freq=clk_freq, address_width=address_width)
+            rx_source = self.phy.source
         else:
             self.phy = ClockDomainsRenamer(cd)(phy)
             self.tx_cdc = stream.ClockDomainCrossing([("data", 8)], cd_from="sys", cd_to=cd)
             self.rx_cdc = stream.ClockDomainCrossing([("data", 8)], cd_from=cd,    cd_to="sys")
             self.comb += self.phy.source.connect(self.rx_cdc.sink)
             self.comb += self.tx_cdc.source.connect(self.phy.sink)
-            Stream2Wishbone.__init__(self, clk_freq=clk_freq, address_width=address_width)
-            self.comb += self.rx_cdc.source.connect(self.sink)
+            rx_source = self.rx_cdc.source
+        Stream2Wishbone.__init__(self, clk_freq=clk_freq, address_width=address_width)
+        if rx_fifo_depth:
+            self.rx_fifo = stream.SyncFIFO([("data", 8)], rx_fifo_depth)
+            self.comb += rx_source.connect(self.rx_fifo.sink)
+            rx_source = self.rx_fifo.source
+        self.comb += rx_source.connect(self.sink)
+        if cd == "sys":
+            self.comb += self.source.connect(self.phy.sink)
+        else:
             self.comb += self.source.connect(self.tx_cdc.sink)
 
 class UARTWishboneBridge(UARTBone):
@@ -259,6 +259,13 @@ class Builder:
         )
         write_to_file(os.path.join(self.generated_dir, "csr.h"), csr_contents)
 
+        # Generate compile-time specialized C++ CSR accessors to csr.hpp.
+        csr_cpp_contents = export.get_csr_cpp_header(
+            regions   = self.soc.csr_regions,
+            constants = self.soc.constants,
+        )
+        write_to_file(os.path.join(self.generated_dir, "csr.hpp"), csr_cpp_contents)
+
         # Generate Git SHA1 of tools to git.h
         git_contents = export.get_git_header()
         write_to_file(os.path.join(self.generated_dir, "git.h"), git_contents)
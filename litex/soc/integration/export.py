@@ -442,6 +442,65 @@ def get_csr_header(regions, constants, csr_base=None, with_csr_base_define=True,
     r += "\n#endif /* ! __GENERATED_CSR_H */\n"
     return r
 
+# CSR C++ Header.
+
+_cpp_keywords = {
+    "alignas", "alignof", "and", "asm", "auto", "bool", "break", "case", "catch", "char", "class",
+    "const", "constexpr", "continue", "default", "delete", "do", "double", "else", "enum",
+    "explicit", "export", "extern", "false", "float", "for", "friend", "goto", "if", "inline",
+    "int", "long", "mutable", "namespace", "new", "noexcept", "not", "operator", "or", "private",
+    "protected", "public", "register", "return", "short", "signed", "sizeof", "static", "struct",
+    "switch", "template", "this", "throw", "true", "try", "typedef", "typename", "union",
+    "unsigned", "using", "virtual", "void", "volatile", "while", "xor",
+}
+
+def _cpp_name(name):
+    name = name.lower()
+    return name + "_" if name in _cpp_keywords else name
+
+def _generate_csr_region_cpp(name, region, alignment):
+    r = f"\n/* {name.upper()} Registers */\n"
+    r += f"namespace {_cpp_name(name)} {{\n"
+    for csr in region.obj:
+        nr        = (csr.size + region.busword - 1) // region.busword
+        read_only = "true" if getattr(csr, "read_only", False) else "false"
+        addr      = f"CSR_{name.upper()}_{csr.name.upper()}_ADDR"
+        reg       = _cpp_name(csr.name)
+        ctype, stride = _determine_ctype_and_stride_c(nr * region.busword // 8, alignment)
+        if ctype is None:
+            stride = alignment // 8
+            r += f"using {reg} = csr_bytes<{addr}, {(csr.size + 7) // 8}, {nr}, {region.busword}, {stride}, {read_only}>;\n"
+            continue
+        r += f"using {reg} = csr_reg<{addr}, {ctype}, {nr}, {region.busword}, {stride}, {read_only}>;\n"
+        if hasattr(csr, "fields"):
+            r += f"namespace {csr.name.lower()}_fields {{\n"
+            for field in csr.fields.fields:
+                r += f"\tusing {_cpp_name(field.name)} = csr_field<{reg}, {field.offset}, {field.size}>;\n"
+            r += "}\n"
+    r += f"}} /* namespace {_cpp_name(name)} */\n"
+    return r
+
+def get_csr_cpp_header(regions, constants):
+    """
+    Generate the C++ CSR header file content (compile-time specialized accessors, see hw/csr.hpp).
+    """
+
+    alignment = constants.get("CONFIG_CSR_ALIGNMENT", 32)
+    r = generated_banner("//")
+    r += "#ifndef __GENERATED_CSR_HPP\n"
+    r += "#define __GENERATED_CSR_HPP\n\n"
+    r += "#include <generated/csr.h>\n"
+    r += "#include <hw/csr.hpp>\n\n"
+    r += "namespace litex {\n"
+    r += "namespace csr {\n"
+    for name, region in regions.items():
+        if not isinstance(region.obj, Memory):
+            r += _generate_csr_region_cpp(name, region, alignment)
+    r += "\n} /* namespace csr */\n"
+    r += "} /* namespace litex */\n"
+    r += "\n#endif /* ! __GENERATED_CSR_HPP */\n"
+    return r
+
 # C I2C Export -------------------------------------------------------------------------------------
 
 def get_i2c_header(i2c_init_values):
@@ -449,6 +508,7 @@ def get_i2c_header(i2c_init_values):
 
     r = generated_banner("//")
     r += "#ifndef __GENERATED_I2C_H\n#define __GENERATED_I2C_H\n\n"
+    r += "#include <generated/csr.h>\n"
     r += "#include <libbase/i2c.h>\n\n"
     r += "#define I2C_DEVS_COUNT {}\n\n".format(len(i2c_devs))
 
@@ -465,6 +525,11 @@ def get_i2c_header(i2c_init_values):
         r += "\t\t.ops.w_scl_offset   = CSR_{}_W_SCL_OFFSET,\n".format(name.upper())
         r += "\t\t.ops.w_sda_offset   = CSR_{}_W_SDA_OFFSET,\n".format(name.upper())
         r += "\t\t.ops.w_oe_offset    = CSR_{}_W_OE_OFFSET,\n".format(name.upper())
+        r += "#ifdef CSR_{}_CMD_ADDR\n".format(name.upper())
+        r += "\t\t.ctrl.cmd_addr      = CSR_{}_CMD_ADDR,\n".format(name.upper())
+        r += "\t\t.ctrl.status_addr   = CSR_{}_STATUS_ADDR,\n".format(name.upper())
+        r += "\t\t.ctrl.clkdiv_addr   = CSR_{}_CLKDIV_ADDR,\n".format(name.upper())
+        r += "#endif\n"
         r += "\t\t.name               = \"{}\"\n".format(name)
         r += "\t},\n"
     r += "};\n\n"
@@ -1310,10 +1310,14 @@ class SoC(LiteXModule, SoCCoreCompat):
             self.add_config("CPU_NOP", self.cpu.nop)
 
     # Add Timer ------------------------------------------------------------------------------------
-    def add_timer(self, name="timer0"):
+    def add_timer(self, name="timer0", uptime=True):
         from litex.soc.cores.timer import Timer
         self.check_if_exists(name)
-        self.add_module(name=name, module=Timer())
+        timer = Timer()
+        # Uptime counter is used by the firmware as timebase (libbase/timebase.c).
+        if uptime:
+            timer.add_uptime()
+        self.add_module(name=name, module=timer)
         if self.irq.enabled:
             self.irq.add(name, use_loc_if_exists=True)
 
@@ -1512,7 +1516,7 @@ class LiteXSoC(SoC):
         self.add_config(name, identifier)
 
     # Add UART -------------------------------------------------------------------------------------
-    def add_uart(self, name="uart", uart_name="serial", baudrate=115200, fifo_depth=16):
+    def add_uart(self, name="uart", uart_name="serial", baudrate=115200, fifo_depth=16, with_dynamic_baudrate=False):
         # Imports.
         from litex.soc.cores.uart import UART, UARTCrossover
 
@@ -1588,7 +1592,8 @@ class LiteXSoC(SoC):
         # Regular UART.
         else:
             from litex.soc.cores.uart import UARTPHY
-            uart_phy  = UARTPHY(uart_pads, clk_freq=self.sys_clk_freq, baudrate=baudrate)
+            uart_phy  = UARTPHY(uart_pads, clk_freq=self.sys_clk_freq, baudrate=baudrate,
+                with_dynamic_baudrate=with_dynamic_baudrate)
             uart      = UART(uart_phy, **uart_kwargs)
 
         # Add PHY/UART.
@@ -2079,6 +2084,8 @@ class LiteXSoC(SoC):
         if mode in [ "4x" ]:
             if SpiNorFlashOpCodes.READ_1_1_4 in module.supported_opcodes:
                 self.add_constant(f"{name}_MODULE_QUAD_CAPABLE")
+            if SpiNorFlashOpCodes.PP_1_1_4 in module.supported_opcodes:
+                self.add_constant(f"{name}_MODULE_QUAD_PP_CAPABLE")
             if SpiNorFlashOpCodes.READ_4_4_4 in module.supported_opcodes:
                 self.add_constant(f"{name}_MODULE_QPI_CAPABLE")
         if software_debug:
@@ -2295,6 +2302,51 @@ class LiteXSoC(SoC):
             phy.crg.cd_sata_rx.clk,
         )
 
+    # Add DMA Copy ---------------------------------------------------------------------------------
+    def add_dma_copy(self, name="dma_copy", fifo_depth=16, with_irq=True):
+        # Imports.
+        from litex.soc.cores.dma import WishboneDMACopy
+
+        # Reader/Writer Buses (on the main bus to also reach Flash/ROM regions).
+        buses = []
+        for direction in ["reader", "writer"]:
+            bus = wishbone.Interface(
+                data_width = self.bus.data_width,
+                adr_width  = self.bus.get_address_width(standard="wishbone"),
+                addressing = "word",
+            )
+            self.bus.add_master(name=f"{name}_{direction}", master=bus)
+            buses.append(bus)
+
+        # Core.
+        self.check_if_exists(name)
+        dma_copy = WishboneDMACopy(bus_r=buses[0], bus_w=buses[1], fifo_depth=fifo_depth, with_irq=with_irq)
+        self.add_module(name=name, module=dma_copy)
+
+        # Interrupts.
+        if with_irq and self.irq.enabled:
+            self.irq.add(name, use_loc_if_exists=True)
+
+    # Add CRC32 ------------------------------------------------------------------------------------
+    def add_crc(self, name="crc", with_dma=True):
+        # Imports.
+        from litex.soc.cores.crc import CRC32
+
+        # DMA Reader Bus (on the main bus to also reach Flash/ROM regions).
+        bus = None
+        if with_dma:
+            bus = wishbone.Interface(
+                data_width = 32,
+                adr_width  = self.bus.get_address_width(standard="wishbone"),
+                addressing = "word",
+            )
+            self.bus.add_master(name=f"{name}_dma", master=bus)
+
+        # Core.
+        self.check_if_exists(name)
+        crc = CRC32(bus=bus, endianness=self.cpu.endianness)
+        self.add_module(name=name, module=crc)
+
     # Add PCIe -------------------------------------------------------------------------------------
     def add_pcie(self, name="pcie", phy=None, ndmas=0, max_pending_requests=8, address_width=32, data_width=None,
         with_dma_buffering    = True, dma_buffering_depth=1024,
@@ -100,10 +100,11 @@ class SoCCore(LiteXSoC):
         uart_name                = "serial",
         uart_baudrate            = 115200,
         uart_fifo_depth          = 16,
+        uart_dynamic_baudrate    = False,
 
         # Timer parameters.
         with_timer               = True,
-        timer_uptime             = False,
+        timer_uptime             = True,
 
         # Controller parameters.
         with_ctrl                = True,
@@ -190,6 +191,13 @@ class SoCCore(LiteXSoC):
 
         # FIXME: Move to soc.py?
 
+        # The firmware timebase (libbase/timebase.c) requires the Timer0 uptime counter.
+        if (cpu_type is not None) and with_timer and not timer_uptime:
+            self.logger.error("{} is required by the firmware timebase (libbase/timebase.c), {}.".format(
+                colorer("Timer uptime", color="red"),
+                colorer("only disable it (--no-timer-uptime) on SoCs without CPU", color="red")))
+            raise SoCError()
+
         if with_uart:
             # crossover+uartbone is kept as backward compatibility
             if uart_name == "crossover+uartbone":
@@ -259,7 +267,8 @@ class SoCCore(LiteXSoC):
 
         # Add UART.
         if with_uart:
-            self.add_uart(name="uart", uart_name=uart_name, baudrate=uart_baudrate, fifo_depth=uart_fifo_depth)
+            self.add_uart(name="uart", uart_name=uart_name, baudrate=uart_baudrate, fifo_depth=uart_fifo_depth,
+                with_dynamic_baudrate=uart_dynamic_baudrate)
 
         # Add JTAGBone.
         if with_jtagbone:
@@ -267,9 +276,7 @@ class SoCCore(LiteXSoC):
 
         # Add Timer.
         if with_timer:
-            self.add_timer(name="timer0")
-            if timer_uptime:
-                self.timer0.add_uptime()
+            self.add_timer(name="timer0", uptime=timer_uptime)
 
         # Add Watchdog.
         if with_watchdog:
@@ -335,6 +342,7 @@ def soc_core_args(parser):
     soc_group.add_argument("--uart-name",       default="serial",    type=str,      help="UART type/name.")
     soc_group.add_argument("--uart-baudrate",   default=115200,      type=auto_int, help="UART baudrate.")
     soc_group.add_argument("--uart-fifo-depth", default=16,          type=auto_int, help="UART FIFO depth.")
+    soc_group.add_argument("--uart-dynamic-baudrate", action="store_true",          help="Enable UART dynamic baudrate (serialboot baudrate upshift).")
 
     # UARTBone parameters.
     soc_group.add_argument("--with-uartbone",   action="store_true",                help="Enable UARTbone.")
@@ -345,7 +353,8 @@ def soc_core_args(parser):
 
     # Timer parameters.
     soc_group.add_argument("--no-timer",        action="store_true", help="Disable Timer.")
-    soc_group.add_argument("--timer-uptime",    action="store_true", help="Add an uptime capability to Timer.")
+    soc_group.add_argument("--timer-uptime",    action="store_true", help="Add an uptime capability to Timer (default, kept for compatibility).")
+    soc_group.add_argument("--no-timer-uptime", action="store_true", help="Disable Timer uptime capability (SoCs without CPU only, required by the firmware timebase).")
 
     # Watchdog parameters.
     soc_group.add_argument("--with-watchdog",        action="store_true",         help="Enable Watchdog.")
@@ -370,6 +379,9 @@ def soc_core_argdict(args):
         # Handle specific ident_version case (--no-ident-version is exposed).
         elif a in ["ident_version"]:
             arg = not getattr(args, "no_ident_version", True)
+        # Handle specific timer_uptime case (--no-timer-uptime is exposed).
+        elif a in ["timer_uptime"]:
+            arg = not getattr(args, "no_timer_uptime", False)
         # Regular cases.
         else:
             arg = getattr(args, a, None)
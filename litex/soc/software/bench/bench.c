@@ -0,0 +1,441 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+/* Host (native) micro-benchmarks and correctness tests of the hardware-independent firmware
+ * routines: crc16/crc32, lfsr and memtest pattern generators, jsmn (boot.json), the SDRAM
+ * leveling window search and the benchmark app Dhrystone.
+ *
+ * Usage: bench [-t] (-t: only run the correctness tests).
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <libbase/crc.h>
+#include <libbase/lfsr.h>
+#include <libbase/memtest.h>
+#include <libbase/timebase.h>
+#include <libbase/jsmn.h>
+
+#include <liblitedram/utils.h>
+
+#include <benchmark/dhrystone.h>
+
+#define BENCH_MIN_NS  (100*1000*1000)
+#define MEMTEST_SIZE  (16*1024*1024)
+
+static int failures;
+static volatile uint64_t sink;
+
+#define CHECK(cond) do {                                                   \
+	if (!(cond)) {                                                         \
+		printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);             \
+		failures++;                                                        \
+	}                                                                      \
+} while (0)
+
+/* Timebase ---------------------------------------------------------------------------------------*/
+
+/* Replaces libbase/timebase.c (Timer0): 1 tick = 1ns (CONFIG_CLOCK_FREQUENCY of the stub soc.h). */
+
+uint64_t timebase_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec*1000000000 + ts.tv_nsec;
+}
+
+uint64_t timebase_to_us(uint64_t ticks)
+{
+	return ticks/1000;
+}
+
+uint64_t timebase_from_us(uint64_t us)
+{
+	return us*1000;
+}
+
+void timebase_delay_us(uint64_t us)
+{
+	uint64_t deadline;
+
+	deadline = timebase_deadline_us(us);
+	while (!timebase_expired(deadline));
+}
+
+/* Benchmark --------------------------------------------------------------------------------------*/
+
+typedef void (*bench_func)(void *arg);
+
+/* Run func until BENCH_MIN_NS elapsed and report the per call/per byte time. */
+static void bench(const char *name, bench_func func, void *arg, unsigned long bytes)
+{
+	unsigned long calls, i;
+	uint64_t start, elapsed;
+
+	calls = 1;
+	for (;;) {
+		start = timebase_now();
+		for (i = 0; i < calls; i++)
+			func(arg);
+		elapsed = timebase_now() - start;
+		if (elapsed >= BENCH_MIN_NS)
+			break;
+		calls *= 2;
+	}
+
+	printf("%-32s %12.2f ns/call", name, (double)elapsed/calls);
+	if (bytes)
+		printf(" %10.3f ns/byte", (double)elapsed/calls/bytes);
+	printf("\n");
+}
+
+/* CRC --------------------------------------------------------------------------------------------*/
+
+struct crc_arg {
+	const unsigned char *buffer;
+	unsigned int len;
+};
+
+static void bench_crc16(void *arg)
+{
+	struct crc_arg *a = arg;
+
+	sink += crc16(a->buffer, a->len);
+}
+
+static void bench_crc32(void *arg)
+{
+	struct crc_arg *a = arg;
+
+	sink += crc32(a->buffer, a->len);
+}
+
+static void crc_tests(void)
+{
+	const unsigned char check[] = "123456789";
+
+	CHECK(crc16(check, 9) == 0x31c3); /* CRC-16/XMODEM */
+	CHECK(crc32(check, 9) == 0xcbf43926);
+	CHECK(crc16(check, 0) == 0x0000);
+	CHECK(crc32(check, 0) == 0x00000000);
+}
+
+static void crc_benchs(void)
+{
+	static unsigned char buffer[65536];
+	struct crc_arg arg;
+	unsigned int i;
+
+	for (i = 0; i < sizeof(buffer); i++)
+		buffer[i] = i*7 + (i >> 8);
+
+	/* SFL frame payload / 64KiB block */
+	arg.buffer = buffer;
+	arg.len    = 251;
+	bench("crc16 (251B)", bench_crc16, &arg, arg.len);
+	arg.len    = sizeof(buffer);
+	bench("crc16 (64KiB)", bench_crc16, &arg, arg.len);
+	arg.len    = 251;
+	bench("crc32 (251B)", bench_crc32, &arg, arg.len);
+	arg.len    = sizeof(buffer);
+	bench("crc32 (64KiB)", bench_crc32, &arg, arg.len);
+}
+
+/* LFSR / Memtest ---------------------------------------------------------------------------------*/
+
+static void lfsr_tests(void)
+{
+	unsigned long period;
+	uint64_t state;
+
+	/* Maximal length sequences */
+	state  = 1;
+	period = 0;
+	do {
+		state = lfsr(8, state);
+		period++;
+	} while (state != 1 && period <= 256);
+	CHECK(period == 255);
+
+	state  = 1;
+	period = 0;
+	do {
+		state = lfsr(16, state);
+		period++;
+	} while (state != 1 && period <= 65536);
+	CHECK(period == 65535);
+
+	state = 1;
+	for (period = 0; period < 1000000; period++) {
+		state = lfsr(32, state);
+		if (state == 0 || state == 1 || state > 0xffffffff)
+			break;
+	}
+	CHECK(period == 1000000);
+}
+
+static void bench_lfsr32(void *arg)
+{
+	uint64_t *state = arg;
+	int i;
+
+	for (i = 0; i < 1024; i++)
+		*state = lfsr(32, *state);
+	sink += *state;
+}
+
+struct memtest_arg {
+	unsigned int *buffer;
+	unsigned long size;
+	int errors;
+};
+
+static int count_error(unsigned int addr, unsigned int rdata, unsigned int refdata, void *arg)
+{
+	struct memtest_arg *a = arg;
+
+	a->errors++;
+	return 0;
+}
+
+static void memtest_tests(void)
+{
+	struct memtest_config config = {0};
+	struct memtest_arg arg;
+
+	arg.size   = 1024*1024;
+	arg.buffer = malloc(arg.size);
+	arg.errors = 0;
+	CHECK(arg.buffer != NULL);
+	if (arg.buffer == NULL)
+		return;
+
+	CHECK(memtest_bus(arg.buffer, arg.size) == 0);
+	CHECK(memtest_addr(arg.buffer, 128*1024, 0) == 0); /* Up to 2^16 words */
+	CHECK(memtest_addr(arg.buffer, 128*1024, 1) == 0);
+	CHECK(memtest_data(arg.buffer, arg.size, 0, &config) == 0);
+	CHECK(memtest_data(arg.buffer, arg.size, 1, &config) == 0);
+
+	/* Corruption must be detected (and reported through the callback) */
+	config.read_only = 1;
+	config.on_error  = count_error;
+	config.arg       = &arg;
+	arg.buffer[1234] ^= 0x10;
+	CHECK(memtest_data(arg.buffer, arg.size, 1, &config) == 1);
+	CHECK(arg.errors == 1);
+
+	free(arg.buffer);
+}
+
+static void bench_memtest_data(void *arg)
+{
+	struct memtest_config config = {0};
+	struct memtest_arg *a = arg;
+
+	a->errors += memtest_data(a->buffer, a->size, 1, &config);
+}
+
+static void memtest_benchs(void)
+{
+	struct memtest_arg arg;
+	uint64_t state = 1;
+
+	bench("lfsr32 (1024 steps)", bench_lfsr32, &state, 0);
+
+	arg.size   = MEMTEST_SIZE;
+	arg.buffer = malloc(arg.size);
+	arg.errors = 0;
+	if (arg.buffer == NULL)
+		return;
+	bench("memtest_data (16MiB, random)", bench_memtest_data, &arg, arg.size);
+	CHECK(arg.errors == 0);
+	free(arg.buffer);
+}
+
+/* JSON -------------------------------------------------------------------------------------------*/
+
+static const char boot_json[] =
+	"{\n"
+	"\t\"Image\":       \"0x40000000\",\n"
+	"\t\"rv32.dtb\":    \"0x40ef0000\",\n"
+	"\t\"opensbi.bin\": \"0x40f00000\",\n"
+	"\t\"bootargs\": {\n"
+	"\t\t\"r1\":   \"0x40ef0000\",\n"
+	"\t\t\"addr\": \"0x40f00000\"\n"
+	"\t}\n"
+	"}\n";
+
+static int json_key_is(const char *js, jsmntok_t *t, const char *key)
+{
+	return (t->type == JSMN_STRING) && (t->size == 1) &&
+		((int)strlen(key) == t->end - t->start) &&
+		(strncmp(js + t->start, key, t->end - t->start) == 0);
+}
+
+static void json_tests(void)
+{
+	jsmntok_t t[32];
+	jsmn_parser p;
+	int count;
+
+	jsmn_init(&p);
+	count = jsmn_parse(&p, boot_json, strlen(boot_json), t, sizeof(t)/sizeof(*t));
+	CHECK(count == 13);
+	if (count != 13)
+		return;
+	CHECK(t[0].type == JSMN_OBJECT && t[0].size == 4);
+	CHECK(json_key_is(boot_json, &t[1], "Image"));
+	CHECK(strtoul(boot_json + t[2].start, NULL, 0) == 0x40000000);
+	CHECK(json_key_is(boot_json, &t[7], "bootargs"));
+	CHECK(t[8].type == JSMN_OBJECT && t[8].size == 2);
+	CHECK(json_key_is(boot_json, &t[11], "addr"));
+	CHECK(strtoul(boot_json + t[12].start, NULL, 0) == 0x40f00000);
+
+	/* Truncated file / Too many tokens */
+	jsmn_init(&p);
+	CHECK(jsmn_parse(&p, boot_json, 20, t, sizeof(t)/sizeof(*t)) == JSMN_ERROR_PART);
+	jsmn_init(&p);
+	CHECK(jsmn_parse(&p, boot_json, strlen(boot_json), t, 4) == JSMN_ERROR_NOMEM);
+}
+
+static void bench_jsmn(void *arg)
+{
+	jsmntok_t t[32];
+	jsmn_parser p;
+
+	jsmn_init(&p);
+	sink += jsmn_parse(&p, boot_json, strlen(boot_json), t, sizeof(t)/sizeof(*t));
+}
+
+static void json_benchs(void)
+{
+	bench("jsmn_parse (boot.json)", bench_jsmn, NULL, strlen(boot_json));
+}
+
+/* Leveling ---------------------------------------------------------------------------------------*/
+
+/* Leveling scan from a string ('1': working delay). */
+static int scan_from_string(uint32_t *working, const char *scan)
+{
+	int delay;
+
+	memset(working, 0, 512/8);
+	for (delay = 0; scan[delay]; delay++)
+		if (scan[delay] == '1')
+			working[delay/32] |= 1U << (delay%32);
+	return delay;
+}
+
+static void leveling_window_test(const char *scan, int min, int max)
+{
+	uint32_t working[512/32];
+	int ndelays;
+	int delay_min, delay_max;
+	int found;
+
+	ndelays = scan_from_string(working, scan);
+	found = sdram_leveling_find_window(working, ndelays, &delay_min, &delay_max);
+	if ((found != (min >= 0)) || (delay_min != min) || (delay_max != max)) {
+		printf("FAIL leveling window %s: %d-%d (expected %d-%d)\n",
+			scan, delay_min, delay_max, min, max);
+		failures++;
+	}
+}
+
+static void leveling_tests(void)
+{
+	char scan[65];
+
+	leveling_window_test("00000000", -1, -1);
+	leveling_window_test("10101010", -1, -1);
+	leveling_window_test("11111111",  0,  7);
+	leveling_window_test("00111100",  2,  5);
+	leveling_window_test("01011110",  3,  6); /* Isolated working delays are ignored */
+	leveling_window_test("11001111",  4,  7); /* Largest window wins */
+	leveling_window_test("11101110",  0,  2); /* First window wins on ties */
+	leveling_window_test("00000011",  6,  7);
+
+	/* Window across 32-bit words */
+	memset(scan, '0', 64);
+	scan[64] = '\0';
+	memset(scan + 30, '1', 11);
+	leveling_window_test(scan, 30, 40);
+}
+
+static void bench_leveling(void *arg)
+{
+	int delay_min, delay_max;
+
+	sdram_leveling_find_window(arg, 512, &delay_min, &delay_max);
+	sink += delay_min + delay_max;
+}
+
+static void leveling_benchs(void)
+{
+	static uint32_t working[512/32];
+	int delay;
+
+	/* Noisy edges around a 200-delays window */
+	for (delay = 150; delay < 350; delay++)
+		working[delay/32] |= 1U << (delay%32);
+	for (delay = 100; delay < 150; delay += 3)
+		working[delay/32] |= 1U << (delay%32);
+	bench("sdram_leveling_find_window (512)", bench_leveling, working, 0);
+}
+
+/* Dhrystone --------------------------------------------------------------------------------------*/
+
+static void dhrystone_tests(void)
+{
+	uint64_t cycles;
+
+	CHECK(dhrystone(1, &cycles));
+	CHECK(dhrystone(1000, &cycles));
+}
+
+static void bench_dhrystone(void *arg)
+{
+	uint64_t cycles;
+
+	sink += dhrystone(1000, &cycles);
+}
+
+static void dhrystone_benchs(void)
+{
+	bench("dhrystone (1000 runs)", bench_dhrystone, NULL, 0);
+}
+
+/* Main -------------------------------------------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+	int tests_only;
+
+	tests_only = (argc > 1) && (strcmp(argv[1], "-t") == 0);
+
+	crc_tests();
+	lfsr_tests();
+	memtest_tests();
+	json_tests();
+	leveling_tests();
+	dhrystone_tests();
+	if (failures) {
+		printf("%d test(s) failed.\n", failures);
+		return 1;
+	}
+	printf("All tests passed.\n");
+	if (tests_only)
+		return 0;
+
+	crc_benchs();
+	memtest_benchs();
+	json_benchs();
+	leveling_benchs();
+	dhrystone_benchs();
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,268 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+/* Host (native) FatFs benchmark: runs libfatfs (ff.c with the firmware ffconf.h, the optional
+ * disk cache and the BIOS file loader) over a disk image file and reports how file reads are
+ * turned into disk requests, with a simple device model (per-request latency + bandwidth).
+ *
+ * By default the sdcardboot_from_json sequence is replayed: boot.json is read and parsed and
+ * each image it lists is loaded to a RAM buffer (with its crc32 printed for verification).
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <libbase/crc.h>
+#include <libbase/jsmn.h>
+
+#include <libfatfs/ff.h>
+#include <libfatfs/diskio.h>
+#include <libfatfs/diskcache.h>
+#include <libfatfs/fileload.h>
+
+/* Request sizes histogram bins (in sectors): 1, 2-7, 8-63, 64-511, 512+. */
+#define IMGDISK_BINS 5
+
+struct imgdisk_stats {
+	unsigned long requests;
+	unsigned long sectors;
+	unsigned long multi;      /* Multi-sector requests */
+	unsigned long contiguous; /* Requests starting where the previous one ended */
+	unsigned long bins[IMGDISK_BINS];
+	double        time_us;    /* Modeled device time */
+};
+
+static FILE    *imgdisk_file;
+static LBA_t    imgdisk_sectors;
+static LBA_t    imgdisk_next = (LBA_t) -1;
+static double   imgdisk_latency_us   = 100.0; /* Per request (command, access time) */
+static double   imgdisk_bandwidth_mb = 12.5;  /* MB/s (SD 4-bit @ 25MHz) */
+static int      imgdisk_trace;
+static struct imgdisk_stats imgdisk_stats;
+
+/*-----------------------------------------------------------------------*/
+/* Image file FatFs disk functions                                       */
+/*-----------------------------------------------------------------------*/
+
+static DSTATUS imgdisk_status(BYTE pdrv) {
+	if (pdrv) return STA_NOINIT;
+	return imgdisk_file ? 0 : STA_NOINIT;
+}
+
+static DSTATUS imgdisk_initialize(BYTE pdrv) {
+	return imgdisk_status(pdrv);
+}
+
+static DRESULT imgdisk_read(BYTE pdrv, BYTE *buf, LBA_t sector, UINT count) {
+	unsigned bin;
+
+	if (pdrv || (count == 0))
+		return RES_PARERR;
+	if (sector + count > imgdisk_sectors)
+		return RES_ERROR;
+
+	if (imgdisk_trace)
+		printf("  read %8lu +%u\n", (unsigned long) sector, count);
+	imgdisk_stats.requests++;
+	imgdisk_stats.sectors += count;
+	if (count > 1)
+		imgdisk_stats.multi++;
+	if (sector == imgdisk_next)
+		imgdisk_stats.contiguous++;
+	imgdisk_next = sector + count;
+	bin = (count >= 512) ? 4 : (count >= 64) ? 3 : (count >= 8) ? 2 : (count >= 2) ? 1 : 0;
+	imgdisk_stats.bins[bin]++;
+	imgdisk_stats.time_us += imgdisk_latency_us + count*FF_MAX_SS/imgdisk_bandwidth_mb;
+
+	if (fseek(imgdisk_file, (long) sector*FF_MAX_SS, SEEK_SET) != 0)
+		return RES_ERROR;
+	if (fread(buf, FF_MAX_SS, count, imgdisk_file) != count)
+		return RES_ERROR;
+	return RES_OK;
+}
+
+static DISKOPS ImgDiskOps = {
+	.disk_initialize = imgdisk_initialize,
+	.disk_status = imgdisk_status,
+	.disk_read = imgdisk_read,
+};
+
+/*-----------------------------------------------------------------------*/
+/* Workloads                                                             */
+/*-----------------------------------------------------------------------*/
+
+static uint8_t      *ram;
+static unsigned long ram_base = 0x40000000;
+static unsigned long ram_size = 64*1024*1024;
+static unsigned long loaded_bytes;
+
+static int load_file(const char *filename, unsigned long address)
+{
+	FATFS fs;
+	FIL file;
+	unsigned long length;
+
+	/* Get length (to check the RAM range and crc32 the loaded data). */
+	if (f_mount(&fs, "", 1) != FR_OK)
+		return 0;
+	if (f_open(&file, filename, FA_READ) != FR_OK) {
+		printf("%s file not found.\n", filename);
+		f_mount(0, "", 0);
+		return 0;
+	}
+	length = f_size(&file);
+	f_close(&file);
+	f_mount(0, "", 0);
+	if ((address < ram_base) || (address - ram_base + length > ram_size)) {
+		printf("%s: 0x%08lx-0x%08lx outside of RAM.\n", filename, address, address + length);
+		return 0;
+	}
+
+	if (!fatfs_copy_file_to_ram(filename, (unsigned long) (ram + (address - ram_base))))
+		return 0;
+	loaded_bytes += length;
+	printf("%s: %lu bytes, crc32 0x%08x\n", filename, length,
+		crc32(ram + (address - ram_base), length));
+	return 1;
+}
+
+/* Same sequence than sdcardboot_from_json (bios/boot.c). */
+static int replay_boot_json(const char *filename)
+{
+	FATFS fs;
+	FIL file;
+	UINT length;
+	int i, count;
+	char json_buffer[1024];
+	char json_name[32];
+	char json_value[32];
+	jsmntok_t t[32];
+	jsmn_parser p;
+
+	/* Read JSON file */
+	if (f_mount(&fs, "", 1) != FR_OK) {
+		printf("Mount failed.\n");
+		return 0;
+	}
+	if (f_open(&file, filename, FA_READ) != FR_OK) {
+		printf("%s file not found.\n", filename);
+		f_mount(0, "", 0);
+		return 0;
+	}
+	memset(json_buffer, 0, sizeof(json_buffer));
+	f_read(&file, json_buffer, sizeof(json_buffer) - 1, &length);
+	f_close(&file);
+	f_mount(0, "", 0);
+
+	/* Parse JSON file and load Images (bootargs are skipped) */
+	jsmn_init(&p);
+	count = jsmn_parse(&p, json_buffer, strlen(json_buffer), t, sizeof(t)/sizeof(*t));
+	for (i=0; i<count-1; i++) {
+		if ((t[i].type != JSMN_STRING) || (t[i].size != 1) || (t[i+1].type != JSMN_STRING))
+			continue;
+		if (((t[i].end - t[i].start) >= sizeof(json_name)) || ((t[i+1].end - t[i+1].start) >= sizeof(json_value)))
+			continue;
+		memset(json_name,  0, sizeof(json_name));
+		memset(json_value, 0, sizeof(json_value));
+		memcpy(json_name,  json_buffer + t[i].start,   t[i].end - t[i].start);
+		memcpy(json_value, json_buffer + t[i+1].start, t[i+1].end - t[i+1].start);
+		if ((strcmp(json_name, "addr") == 0) || (strcmp(json_name, "r1") == 0) ||
+			(strcmp(json_name, "r2") == 0) || (strcmp(json_name, "r3") == 0))
+			continue;
+		if (!load_file(json_name, strtoul(json_value, NULL, 0)))
+			return 0;
+	}
+	return 1;
+}
+
+/*-----------------------------------------------------------------------*/
+/* Main                                                                  */
+/*-----------------------------------------------------------------------*/
+
+static void usage(void)
+{
+	printf("Usage: fatfs_bench [options] image\n"
+		"  -f file   Load file to the RAM base (default: replay boot.json).\n"
+		"  -l us     Device latency per request (default: %.1fus).\n"
+		"  -b MB/s   Device bandwidth (default: %.1fMB/s).\n"
+		"  -c KiB    Insert the FatFs disk cache with this size (default: none).\n"
+		"  -r base   RAM base address (default: 0x%08lx).\n"
+		"  -v        Trace disk requests.\n",
+		imgdisk_latency_us, imgdisk_bandwidth_mb, ram_base);
+}
+
+int main(int argc, char **argv)
+{
+	const char *filename = NULL;
+	unsigned long cache_size = 0;
+	void *cache = NULL;
+	struct fatfs_cache_stats cache_stats;
+	int opt, ok;
+
+	while ((opt = getopt(argc, argv, "f:l:b:c:r:vh")) != -1) {
+		switch (opt) {
+		case 'f': filename             = optarg; break;
+		case 'l': imgdisk_latency_us   = strtod(optarg, NULL); break;
+		case 'b': imgdisk_bandwidth_mb = strtod(optarg, NULL); break;
+		case 'c': cache_size           = strtoul(optarg, NULL, 0)*1024; break;
+		case 'r': ram_base             = strtoul(optarg, NULL, 0); break;
+		case 'v': imgdisk_trace        = 1; break;
+		default:
+			usage();
+			return 1;
+		}
+	}
+	if ((optind != argc - 1) || (imgdisk_bandwidth_mb <= 0)) {
+		usage();
+		return 1;
+	}
+
+	/* Disk */
+	imgdisk_file = fopen(argv[optind], "rb");
+	if (imgdisk_file == NULL) {
+		perror(argv[optind]);
+		return 1;
+	}
+	fseek(imgdisk_file, 0, SEEK_END);
+	imgdisk_sectors = ftell(imgdisk_file)/FF_MAX_SS;
+	FfDiskOps = &ImgDiskOps;
+	if (cache_size) {
+		cache = malloc(cache_size);
+		fatfs_cache_init(cache, cache_size);
+		fatfs_set_ops_cache();
+	}
+
+	/* Workload */
+	ram = malloc(ram_size);
+	if ((ram == NULL) || ((cache_size != 0) && (cache == NULL))) {
+		printf("Out of memory.\n");
+		return 1;
+	}
+	if (filename != NULL)
+		ok = load_file(filename, ram_base);
+	else
+		ok = replay_boot_json("boot.json");
+
+	/* Report */
+	printf("\nDisk requests: %lu (%lu multi-sector, %lu contiguous)\n",
+		imgdisk_stats.requests, imgdisk_stats.multi, imgdisk_stats.contiguous);
+	printf("  Sizes (sectors): 1: %lu, 2-7: %lu, 8-63: %lu, 64-511: %lu, 512+: %lu\n",
+		imgdisk_stats.bins[0], imgdisk_stats.bins[1], imgdisk_stats.bins[2],
+		imgdisk_stats.bins[3], imgdisk_stats.bins[4]);
+	printf("  Sectors: %lu (%lu bytes)\n", imgdisk_stats.sectors, imgdisk_stats.sectors*FF_MAX_SS);
+	printf("Modeled time: %.3fms (%.1fus/request, %.1fMB/s), %lu bytes loaded: %.2fMB/s effective\n",
+		imgdisk_stats.time_us/1000, imgdisk_latency_us, imgdisk_bandwidth_mb, loaded_bytes,
+		imgdisk_stats.time_us ? loaded_bytes/imgdisk_stats.time_us : 0.0);
+	if (cache_size) {
+		fatfs_cache_get_stats(&cache_stats);
+		printf("Cache: %u hits, %u misses\n", cache_stats.hits, cache_stats.misses);
+	}
+
+	fclose(imgdisk_file);
+	free(ram);
+	free(cache);
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,6 @@
+#ifndef __GENERATED_CSR_H
+#define __GENERATED_CSR_H
+
+/* Host stub: no CSR peripherals, so CSR-dependent code paths are compiled out. */
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef __GENERATED_MEM_H
+#define __GENERATED_MEM_H
+
+/* Host stub: no memory regions. */
+
+#endif
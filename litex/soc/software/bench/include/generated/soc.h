@@ -0,0 +1,7 @@
+#ifndef __GENERATED_SOC_H
+#define __GENERATED_SOC_H
+
+/* Host stub: the timebase is provided by the bench runner in nanoseconds. */
+#define CONFIG_CLOCK_FREQUENCY 1000000000
+
+#endif
@@ -0,0 +1,12 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#ifndef __SYSTEM_H
+#define __SYSTEM_H
+
+/* Host stub of the CPU system.h: caches are coherent, nothing to flush. */
+
+static inline void flush_cpu_icache(void) {}
+static inline void flush_cpu_dcache(void) {}
+static inline void flush_l2_cache(void) {}
+
+#endif /* __SYSTEM_H */
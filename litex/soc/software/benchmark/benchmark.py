@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+
+#
+# This file is part of LiteX.
+#
+# SPDX-License-Identifier: BSD-2-Clause
+
+import os
+import sys
+import argparse
+
+from litex.build.tools import replace_in_file
+
+def main():
+    parser = argparse.ArgumentParser(description="LiteX Bare Metal Benchmark App.")
+    parser.add_argument("--build-path",                        help="Target's build path (ex build/board_name).", required=True)
+    parser.add_argument("--mem",          default="main_ram",  help="Memory Region where code will be loaded/executed.")
+    parser.add_argument("--coremark-dir", default=None,        help="CoreMark sources (https://github.com/eembc/coremark), CoreMark is skipped when not provided.")
+    parser.add_argument("--buf-size",     default=None,        help="Size of the memcpy/crc32 buffers (default: 8192, 2 buffers).")
+    parser.add_argument("--opt",          default="-O2",       help="Optimization flags of the benchmarks.")
+    parser.add_argument("--autorun",      action="store_true", help="Run all benchmarks at startup and finish the simulation (litex_sim --sim-debug).")
+    args = parser.parse_args()
+
+    # Create benchmark directory
+    os.makedirs("benchmark", exist_ok=True)
+
+    # Copy contents to benchmark directory
+    os.system(f"cp {os.path.abspath(os.path.dirname(__file__))}/* benchmark")
+    os.system("chmod -R u+w benchmark") # Nix specific: Allow linker script to be modified.
+
+    # Update memory region.
+    replace_in_file("benchmark/linker.ld", "main_ram", args.mem)
+
+    # Compile benchmark
+    build_path = args.build_path if os.path.isabs(args.build_path) else os.path.join("..", args.build_path)
+    env = [f"export BUILD_DIR={build_path}", f"export BENCHMARK_OPT=\"{args.opt}\""]
+    if args.coremark_dir is not None:
+        env.append(f"export COREMARK_DIR={os.path.abspath(args.coremark_dir)}")
+    if args.buf_size is not None:
+        env.append(f"export BENCHMARK_BUF_SIZE={int(args.buf_size, 0)}")
+    if args.autorun:
+        env.append("export BENCHMARK_AUTORUN=1")
+    os.system(" && ".join(env + ["cd benchmark", "make"]))
+
+    # Copy benchmark.bin
+    os.system("cp benchmark/benchmark.bin ./")
+
+    # Prepare flash boot image.
+    python3 = sys.executable or "python3" # Nix specific: Reuse current Python executable if available.
+    os.system(f"{python3} -m litex.soc.software.crcfbigen benchmark.bin -o benchmark.fbi --fbi --little") # FIXME: Endianness.
+
+if __name__ == "__main__":
+    main()
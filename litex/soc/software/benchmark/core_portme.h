@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#ifndef __CORE_PORTME_H
+#define __CORE_PORTME_H
+
+/* CoreMark port for the LiteX benchmark app: CoreMark sources are taken unmodified from
+ * COREMARK_DIR (https://github.com/eembc/coremark), core_main.c is built with main renamed to
+ * coremark_main and the number of iterations is passed through seed4_volatile (0: CoreMark
+ * auto-calibration, ~10s). Time is measured in sys_clk cycles with the libbase timebase.
+ */
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <generated/soc.h>
+
+#define HAS_FLOAT  0
+#define HAS_TIME_H 0
+#define USE_CLOCK  0
+#define HAS_STDIO  1
+#define HAS_PRINTF 1
+
+#ifndef COMPILER_VERSION
+#ifdef __GNUC__
+#define COMPILER_VERSION "GCC"__VERSION__
+#else
+#define COMPILER_VERSION "Please put compiler version here (e.g. gcc 4.1)"
+#endif
+#endif
+#ifndef COMPILER_FLAGS
+#define COMPILER_FLAGS FLAGS_STR
+#endif
+#ifndef MEM_LOCATION
+#define MEM_LOCATION "STACK"
+#endif
+
+typedef signed short   ee_s16;
+typedef unsigned short ee_u16;
+typedef signed int     ee_s32;
+typedef double         ee_f32;
+typedef unsigned char  ee_u8;
+typedef unsigned int   ee_u32;
+typedef uintptr_t      ee_ptr_int;
+typedef size_t         ee_size_t;
+
+typedef uint64_t CORE_TICKS;
+
+#define align_mem(x) (void *)(4 + (((ee_ptr_int)(x) - 1) & ~3))
+
+#define SEED_METHOD       SEED_VOLATILE
+#define MEM_METHOD        MEM_STACK
+#define MULTITHREAD       1
+#define MAIN_HAS_NOARGC   1
+#define MAIN_HAS_NORETURN 0
+
+typedef struct CORE_PORTABLE_S {
+	ee_u8 portable_id;
+} core_portable;
+
+extern ee_u32 default_num_contexts;
+
+void portable_init(core_portable *p, int *argc, char *argv[]);
+void portable_fini(core_portable *p);
+
+#if !defined(PROFILE_RUN) && !defined(PERFORMANCE_RUN) && !defined(VALIDATION_RUN)
+#define PERFORMANCE_RUN 1
+#endif
+
+/* Benchmark app interface. */
+int coremark_main(void);
+extern volatile ee_s32 seed4_volatile;
+CORE_TICKS coremark_cycles(void);
+
+#endif /* __CORE_PORTME_H */
@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+/* Dhrystone 2.1, first compilation unit (dhry_1.c): the records are statically allocated
+ * (instead of malloc) and the "should be" values printed by the original are checked.
+ */
+
+#include <string.h>
+
+#include <libbase/timebase.h>
+
+#include "dhrystone.h"
+
+Rec_Pointer Ptr_Glob;
+Rec_Pointer Next_Ptr_Glob;
+int         Int_Glob;
+Boolean     Bool_Glob;
+char        Ch_1_Glob;
+char        Ch_2_Glob;
+int         Arr_1_Glob[50];
+int         Arr_2_Glob[50][50];
+
+static Rec_Type Glob_Rec;
+static Rec_Type Next_Glob_Rec;
+
+static void Proc_1(Rec_Pointer Ptr_Val_Par);
+static void Proc_2(One_Fifty *Int_Par_Ref);
+static void Proc_3(Rec_Pointer *Ptr_Ref_Par);
+static void Proc_4(void);
+static void Proc_5(void);
+
+int dhrystone(unsigned long runs, uint64_t *cycles)
+{
+	One_Fifty     Int_1_Loc;
+	One_Fifty     Int_2_Loc;
+	One_Fifty     Int_3_Loc;
+	char          Ch_Index;
+	Enumeration   Enum_Loc;
+	Str_30        Str_1_Loc;
+	Str_30        Str_2_Loc;
+	unsigned long Run_Index;
+	uint64_t      begin;
+
+	/* Initializations */
+	Next_Ptr_Glob = &Next_Glob_Rec;
+	Ptr_Glob      = &Glob_Rec;
+
+	Ptr_Glob->Ptr_Comp                = Next_Ptr_Glob;
+	Ptr_Glob->Discr                   = Ident_1;
+	Ptr_Glob->variant.var_1.Enum_Comp = Ident_3;
+	Ptr_Glob->variant.var_1.Int_Comp  = 40;
+	strcpy(Ptr_Glob->variant.var_1.Str_Comp, "DHRYSTONE PROGRAM, SOME STRING");
+	strcpy(Str_1_Loc, "DHRYSTONE PROGRAM, 1'ST STRING");
+
+	Arr_2_Glob[8][7] = 10;
+
+	/* Final values when runs == 0 (not part of the original) */
+	Int_1_Loc = Int_2_Loc = Int_3_Loc = 0;
+	Enum_Loc  = Ident_1;
+
+	/* Main loop */
+	begin = timebase_now();
+	for (Run_Index = 1; Run_Index <= runs; ++Run_Index) {
+		Proc_5();
+		Proc_4();
+		/* Ch_1_Glob == 'A', Ch_2_Glob == 'B', Bool_Glob == true */
+		Int_1_Loc = 2;
+		Int_2_Loc = 3;
+		strcpy(Str_2_Loc, "DHRYSTONE PROGRAM, 2'ND STRING");
+		Enum_Loc = Ident_2;
+		Bool_Glob = !Func_2(Str_1_Loc, Str_2_Loc);
+		/* Bool_Glob == 1 */
+		while (Int_1_Loc < Int_2_Loc) { /* Loop body executed once */
+			Int_3_Loc = 5 * Int_1_Loc - Int_2_Loc;
+			/* Int_3_Loc == 7 */
+			Proc_7(Int_1_Loc, Int_2_Loc, &Int_3_Loc);
+			/* Int_3_Loc == 7 */
+			Int_1_Loc += 1;
+		}
+		/* Int_1_Loc == 3, Int_2_Loc == 3, Int_3_Loc == 7 */
+		Proc_8(Arr_1_Glob, Arr_2_Glob, Int_1_Loc, Int_3_Loc);
+		/* Int_Glob == 5 */
+		Proc_1(Ptr_Glob);
+		for (Ch_Index = 'A'; Ch_Index <= Ch_2_Glob; ++Ch_Index) { /* Loop body executed twice */
+			if (Enum_Loc == Func_1(Ch_Index, 'C')) { /* Then, not executed */
+				Proc_6(Ident_1, &Enum_Loc);
+				strcpy(Str_2_Loc, "DHRYSTONE PROGRAM, 3'RD STRING");
+				Int_2_Loc = Run_Index;
+				Int_Glob  = Run_Index;
+			}
+		}
+		/* Int_1_Loc == 3, Int_2_Loc == 3, Int_3_Loc == 7 */
+		Int_2_Loc = Int_2_Loc * Int_1_Loc;
+		Int_1_Loc = Int_2_Loc / Int_3_Loc;
+		Int_2_Loc = 7 * (Int_2_Loc - Int_3_Loc) - Int_1_Loc;
+		/* Int_1_Loc == 1, Int_2_Loc == 13, Int_3_Loc == 7 */
+		Proc_2(&Int_1_Loc);
+		/* Int_1_Loc == 5 */
+	}
+	*cycles = timebase_now() - begin;
+
+	/* Final values */
+	return (Int_Glob == 5) &&
+		(Bool_Glob == 1) &&
+		(Ch_1_Glob == 'A') &&
+		(Ch_2_Glob == 'B') &&
+		(Arr_1_Glob[8] == 7) &&
+		(Arr_2_Glob[8][7] == (int) runs + 10) &&
+		(Ptr_Glob->Discr == Ident_1) &&
+		(Ptr_Glob->variant.var_1.Enum_Comp == Ident_3) &&
+		(Ptr_Glob->variant.var_1.Int_Comp == 17) &&
+		(strcmp(Ptr_Glob->variant.var_1.Str_Comp, "DHRYSTONE PROGRAM, SOME STRING") == 0) &&
+		(Next_Ptr_Glob->Ptr_Comp == Ptr_Glob->Ptr_Comp) &&
+		(Next_Ptr_Glob->Discr == Ident_1) &&
+		(Next_Ptr_Glob->variant.var_1.Enum_Comp == Ident_2) &&
+		(Next_Ptr_Glob->variant.var_1.Int_Comp == 18) &&
+		(strcmp(Next_Ptr_Glob->variant.var_1.Str_Comp, "DHRYSTONE PROGRAM, SOME STRING") == 0) &&
+		(Int_1_Loc == 5) &&
+		(Int_2_Loc == 13) &&
+		(Int_3_Loc == 7) &&
+		(Enum_Loc == Ident_2) &&
+		(strcmp(Str_1_Loc, "DHRYSTONE PROGRAM, 1'ST STRING") == 0) &&
+		(strcmp(Str_2_Loc, "DHRYSTONE PROGRAM, 2'ND STRING") == 0);
+}
+
+static void Proc_1(Rec_Pointer Ptr_Val_Par)
+{
+	Rec_Pointer Next_Record = Ptr_Val_Par->Ptr_Comp; /* == Ptr_Glob_Next */
+
+	*Ptr_Val_Par->Ptr_Comp = *Ptr_Glob;
+	Ptr_Val_Par->variant.var_1.Int_Comp = 5;
+	Next_Record->variant.var_1.Int_Comp = Ptr_Val_Par->variant.var_1.Int_Comp;
+	Next_Record->Ptr_Comp = Ptr_Val_Par->Ptr_Comp;
+	Proc_3(&Next_Record->Ptr_Comp);
+	/* Ptr_Val_Par->Ptr_Comp->Ptr_Comp == Ptr_Glob->Ptr_Comp */
+	if (Next_Record->Discr == Ident_1) { /* Then, executed */
+		Next_Record->variant.var_1.Int_Comp = 6;
+		Proc_6(Ptr_Val_Par->variant.var_1.Enum_Comp, &Next_Record->variant.var_1.Enum_Comp);
+		Next_Record->Ptr_Comp = Ptr_Glob->Ptr_Comp;
+		Proc_7(Next_Record->variant.var_1.Int_Comp, 10, &Next_Record->variant.var_1.Int_Comp);
+	} else /* Not executed */
+		*Ptr_Val_Par = *Ptr_Val_Par->Ptr_Comp;
+}
+
+static void Proc_2(One_Fifty *Int_Par_Ref)
+{
+	One_Fifty   Int_Loc;
+	Enumeration Enum_Loc = Ident_2;
+
+	Int_Loc = *Int_Par_Ref + 10;
+	do { /* Executed once */
+		if (Ch_1_Glob == 'A') { /* Then, executed */
+			Int_Loc -= 1;
+			*Int_Par_Ref = Int_Loc - Int_Glob;
+			Enum_Loc = Ident_1;
+		}
+	} while (Enum_Loc != Ident_1);
+}
+
+static void Proc_3(Rec_Pointer *Ptr_Ref_Par)
+{
+	if (Ptr_Glob != NULL) /* Then, executed */
+		*Ptr_Ref_Par = Ptr_Glob->Ptr_Comp;
+	Proc_7(10, Int_Glob, &Ptr_Glob->variant.var_1.Int_Comp);
+}
+
+static void Proc_4(void)
+{
+	Boolean Bool_Loc;
+
+	Bool_Loc = Ch_1_Glob == 'A';
+	Bool_Glob = Bool_Loc | Bool_Glob;
+	Ch_2_Glob = 'B';
+}
+
+static void Proc_5(void)
+{
+	Ch_1_Glob = 'A';
+	Bool_Glob = 0;
+}
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#ifndef __DHRYSTONE_H
+#define __DHRYSTONE_H
+
+/* Dhrystone 2.1 (R. P. Weicker, C version by R. Richardson): global declarations shared by
+ * dhrystone.c (main loop, Proc_1 to Proc_5) and dhrystone_2.c (Proc_6 to Proc_8, Func_1 to
+ * Func_3). The two parts are kept in separate compilation units, as in the original.
+ */
+
+#include <stdint.h>
+
+typedef enum {Ident_1, Ident_2, Ident_3, Ident_4, Ident_5} Enumeration;
+
+typedef int     One_Thirty;
+typedef int     One_Fifty;
+typedef char    Capital_Letter;
+typedef int     Boolean;
+typedef char    Str_30[31];
+typedef int     Arr_1_Dim[50];
+typedef int     Arr_2_Dim[50][50];
+
+typedef struct record {
+	struct record *Ptr_Comp;
+	Enumeration    Discr;
+	union {
+		struct {
+			Enumeration Enum_Comp;
+			int         Int_Comp;
+			char        Str_Comp[31];
+		} var_1;
+		struct {
+			Enumeration E_Comp_2;
+			char        Str_2_Comp[31];
+		} var_2;
+		struct {
+			char        Ch_1_Comp;
+			char        Ch_2_Comp;
+		} var_3;
+	} variant;
+} Rec_Type, *Rec_Pointer;
+
+extern Rec_Pointer Ptr_Glob;
+extern int         Int_Glob;
+extern Boolean     Bool_Glob;
+extern char        Ch_1_Glob;
+extern char        Ch_2_Glob;
+
+void        Proc_6(Enumeration Enum_Val_Par, Enumeration *Enum_Ref_Par);
+void        Proc_7(One_Fifty Int_1_Par_Val, One_Fifty Int_2_Par_Val, One_Fifty *Int_Par_Ref);
+void        Proc_8(Arr_1_Dim Arr_1_Par_Ref, Arr_2_Dim Arr_2_Par_Ref, int Int_1_Par_Val, int Int_2_Par_Val);
+Enumeration Func_1(Capital_Letter Ch_1_Par_Val, Capital_Letter Ch_2_Par_Val);
+Boolean     Func_2(Str_30 Str_1_Par_Ref, Str_30 Str_2_Par_Ref);
+Boolean     Func_3(Enumeration Enum_Par_Val);
+
+/* Run Number_Of_Runs iterations, return the number of cycles of the measured loop in *cycles and
+ * whether the final values match the ones expected by the Dhrystone specification. */
+int dhrystone(unsigned long runs, uint64_t *cycles);
+
+#endif /* __DHRYSTONE_H */
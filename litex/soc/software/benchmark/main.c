@@ -0,0 +1,367 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+/* LiteX bare metal benchmark app: CoreMark, Dhrystone and memory/crc32 kernels timed in sys_clk
+ * cycles with the libbase timebase. Each result is printed as a single parseable line:
+ *
+ *   bench: <name> key=value key=value ...
+ *
+ * where per_s_per_mhz (iterations/s/MHz, i.e. iterations per million cycles) only depends on the
+ * CPU/memory configuration, not on the clock frequency of the SoC.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <irq.h>
+#include <libbase/uart.h>
+#include <libbase/console.h>
+#include <libbase/crc.h>
+#include <libbase/timebase.h>
+#include <generated/csr.h>
+#include <generated/soc.h>
+
+#include "dhrystone.h"
+#ifdef WITH_COREMARK
+#include "core_portme.h"
+#endif
+
+#ifndef BENCHMARK_BUF_SIZE
+#define BENCHMARK_BUF_SIZE 8192
+#endif
+
+#ifndef DHRYSTONE_RUNS
+#define DHRYSTONE_RUNS 20000
+#endif
+
+#ifndef COREMARK_ITERATIONS
+#define COREMARK_ITERATIONS 10
+#endif
+
+#define KERNEL_ITERATIONS 16
+
+static uint8_t src_buf[BENCHMARK_BUF_SIZE] __attribute__((aligned(64)));
+static uint8_t dst_buf[BENCHMARK_BUF_SIZE] __attribute__((aligned(64)));
+
+/*-----------------------------------------------------------------------*/
+/* Results                                                               */
+/*-----------------------------------------------------------------------*/
+
+/* Print num/den with 3 decimals. */
+static void print_fixed(const char *key, uint64_t num, uint64_t den)
+{
+	uint64_t v;
+
+	v = den ? (num*1000 + den/2)/den : 0;
+	printf(" %s=%" PRIu64 ".%03" PRIu64, key, v/1000, v%1000);
+}
+
+static void print_rate(uint64_t iterations, uint64_t cycles)
+{
+	printf(" cycles=%" PRIu64, cycles);
+	print_fixed("per_s",         iterations*CONFIG_CLOCK_FREQUENCY, cycles);
+	print_fixed("per_s_per_mhz", iterations*1000000, cycles);
+}
+
+static void info_cmd(void)
+{
+	printf("bench: info cpu=%s clk_hz=%u buf_bytes=%u",
+#ifdef CONFIG_CPU_HUMAN_NAME
+		CONFIG_CPU_HUMAN_NAME,
+#else
+		"unknown",
+#endif
+		(unsigned int) CONFIG_CLOCK_FREQUENCY,
+		(unsigned int) BENCHMARK_BUF_SIZE);
+#ifdef CONFIG_L2_SIZE
+	printf(" l2_bytes=%u", (unsigned int) CONFIG_L2_SIZE);
+#endif
+	printf("\n");
+}
+
+/*-----------------------------------------------------------------------*/
+/* Kernels                                                               */
+/*-----------------------------------------------------------------------*/
+
+static unsigned long get_size(int nb_params, char **params)
+{
+	unsigned long size = BENCHMARK_BUF_SIZE;
+	char *c;
+
+	if (nb_params > 0) {
+		size = strtoul(params[0], &c, 0);
+		if ((*c != 0) || (size == 0) || (size > BENCHMARK_BUF_SIZE)) {
+			printf("Incorrect size (1-%u)\n", (unsigned int) BENCHMARK_BUF_SIZE);
+			return 0;
+		}
+	}
+	return size;
+}
+
+static void memcpy_cmd(int nb_params, char **params)
+{
+	unsigned long size = get_size(nb_params, params);
+	uint64_t begin, cycles;
+	int i;
+
+	if (size == 0)
+		return;
+	memset(src_buf, 0x5a, size);
+	memcpy(dst_buf, src_buf, size); /* Warm-up */
+	begin = timebase_now();
+	for (i = 0; i < KERNEL_ITERATIONS; i++)
+		memcpy(dst_buf, src_buf, size);
+	cycles = timebase_now() - begin;
+	printf("bench: memcpy bytes=%lu iterations=%d", size, KERNEL_ITERATIONS);
+	print_rate(KERNEL_ITERATIONS, cycles);
+	print_fixed("bytes_per_cycle", (uint64_t) size*KERNEL_ITERATIONS, cycles);
+	printf(" valid=%d\n", memcmp(dst_buf, src_buf, size) == 0);
+}
+
+static void crc32_cmd(int nb_params, char **params)
+{
+	unsigned long size = get_size(nb_params, params);
+	uint64_t begin, cycles;
+	unsigned long j;
+	int i;
+
+	if (size == 0)
+		return;
+	for (j = 0; j < size; j++)
+		src_buf[j] = j;
+	crc32(src_buf, size); /* Warm-up */
+	begin = timebase_now();
+	for (i = 0; i < KERNEL_ITERATIONS; i++)
+		crc32(src_buf, size);
+	cycles = timebase_now() - begin;
+	printf("bench: crc32 bytes=%lu iterations=%d", size, KERNEL_ITERATIONS);
+	print_rate(KERNEL_ITERATIONS, cycles);
+	print_fixed("bytes_per_cycle", (uint64_t) size*KERNEL_ITERATIONS, cycles);
+	printf(" crc=%08x\n", crc32(src_buf, size));
+}
+
+/*-----------------------------------------------------------------------*/
+/* Dhrystone / CoreMark                                                  */
+/*-----------------------------------------------------------------------*/
+
+static int get_count(int nb_params, char **params, unsigned long *count)
+{
+	char *c;
+
+	if (nb_params > 0) {
+		*count = strtoul(params[0], &c, 0);
+		if (*c != 0) {
+			printf("Incorrect count\n");
+			return 0;
+		}
+	}
+	return 1;
+}
+
+static void dhrystone_cmd(int nb_params, char **params)
+{
+	unsigned long runs = DHRYSTONE_RUNS;
+	uint64_t cycles;
+	int valid;
+
+	if (!get_count(nb_params, params, &runs))
+		return;
+	valid = dhrystone(runs, &cycles);
+	printf("bench: dhrystone iterations=%lu", runs);
+	print_rate(runs, cycles);
+	/* DMIPS: Dhrystones/s relative to the VAX 11/780 (1757 Dhrystones/s). */
+	print_fixed("dmips_per_mhz", (uint64_t) runs*1000000, cycles*1757);
+	printf(" valid=%d\n", valid);
+}
+
+#ifdef WITH_COREMARK
+static void coremark_cmd(int nb_params, char **params)
+{
+	unsigned long iterations = COREMARK_ITERATIONS;
+	uint64_t cycles;
+
+	if (!get_count(nb_params, params, &iterations))
+		return;
+	/* 0: CoreMark auto-calibration (at least 10s, as required for a reportable result). */
+	seed4_volatile = iterations;
+	coremark_main();
+	cycles = coremark_cycles();
+	if (iterations != 0) {
+		printf("bench: coremark iterations=%lu", iterations);
+		print_rate(iterations, cycles);
+		printf("\n");
+	}
+}
+#endif
+
+static void all_cmd(void)
+{
+	char *size[1];
+	char  size_str[16];
+
+	info_cmd();
+	dhrystone_cmd(0, NULL);
+#ifdef WITH_COREMARK
+	coremark_cmd(0, NULL);
+#endif
+	/* Kernels from L1-sized buffers up to the full buffer. */
+	size[0] = size_str;
+	snprintf(size_str, sizeof(size_str), "%u", (unsigned int) (BENCHMARK_BUF_SIZE < 1024 ? BENCHMARK_BUF_SIZE : 1024));
+	memcpy_cmd(1, size);
+	crc32_cmd(1, size);
+	memcpy_cmd(0, NULL);
+	crc32_cmd(0, NULL);
+	printf("bench: done\n");
+}
+
+/*-----------------------------------------------------------------------*/
+/* Uart                                                                  */
+/*-----------------------------------------------------------------------*/
+
+static char *readstr(void)
+{
+	char c[2];
+	static char s[64];
+	static int ptr = 0;
+
+	if(readchar_nonblock()) {
+		c[0] = getchar();
+		c[1] = 0;
+		switch(c[0]) {
+			case 0x7f:
+			case 0x08:
+				if(ptr > 0) {
+					ptr--;
+					fputs("\x08 \x08", stdout);
+				}
+				break;
+			case 0x07:
+				break;
+			case '\r':
+			case '\n':
+				s[ptr] = 0x00;
+				fputs("\n", stdout);
+				ptr = 0;
+				return s;
+			default:
+				if(ptr >= (sizeof(s) - 1))
+					break;
+				fputs(c, stdout);
+				s[ptr] = c[0];
+				ptr++;
+				break;
+		}
+	}
+
+	return NULL;
+}
+
+static char *get_token(char **str)
+{
+	char *c, *d;
+
+	c = (char *)strchr(*str, ' ');
+	if(c == NULL) {
+		d = *str;
+		*str = *str+strlen(*str);
+		return d;
+	}
+	*c = 0;
+	d = *str;
+	*str = c+1;
+	return d;
+}
+
+static void prompt(void)
+{
+	printf("\e[92;1mlitex-benchmark-app\e[0m> ");
+}
+
+/*-----------------------------------------------------------------------*/
+/* Help                                                                  */
+/*-----------------------------------------------------------------------*/
+
+static void help(void)
+{
+	puts("\nLiteX benchmark app built "__DATE__" "__TIME__"\n");
+	puts("Available commands:");
+	puts("help               - Show this command");
+	puts("reboot             - Reboot CPU");
+	puts("info               - SoC configuration");
+	puts("all                - Run all benchmarks");
+	puts("dhrystone [runs]   - Dhrystone 2.1");
+#ifdef WITH_COREMARK
+	puts("coremark [iter]    - CoreMark (0: auto, >= 10s)");
+#endif
+	puts("memcpy [bytes]     - memcpy bandwidth");
+	puts("crc32 [bytes]      - crc32 bandwidth");
+}
+
+/*-----------------------------------------------------------------------*/
+/* Console service / Main                                                */
+/*-----------------------------------------------------------------------*/
+
+static void reboot_cmd(void)
+{
+	ctrl_reset_write(1);
+}
+
+static void console_service(void)
+{
+	char *str;
+	char *token;
+	char *params[1];
+	int nb_params;
+
+	str = readstr();
+	if(str == NULL) return;
+	token = get_token(&str);
+	params[0] = get_token(&str);
+	nb_params = (params[0][0] != 0) ? 1 : 0;
+	if(strcmp(token, "help") == 0)
+		help();
+	else if(strcmp(token, "reboot") == 0)
+		reboot_cmd();
+	else if(strcmp(token, "info") == 0)
+		info_cmd();
+	else if(strcmp(token, "all") == 0)
+		all_cmd();
+	else if(strcmp(token, "dhrystone") == 0)
+		dhrystone_cmd(nb_params, params);
+#ifdef WITH_COREMARK
+	else if(strcmp(token, "coremark") == 0)
+		coremark_cmd(nb_params, params);
+#endif
+	else if(strcmp(token, "memcpy") == 0)
+		memcpy_cmd(nb_params, params);
+	else if(strcmp(token, "crc32") == 0)
+		crc32_cmd(nb_params, params);
+	prompt();
+}
+
+int main(void)
+{
+#ifdef CONFIG_CPU_HAS_INTERRUPT
+	irq_setmask(0);
+	irq_setie(1);
+#endif
+	uart_init();
+
+#ifdef BENCHMARK_AUTORUN
+	/* Non-interactive run (CI, litex_sim --sim-debug): run everything and finish the simulation. */
+	all_cmd();
+#ifdef CSR_SIM_FINISH_BASE
+	sim_finish_finish_write(1);
+#endif
+#endif
+
+	help();
+	prompt();
+
+	while(1) {
+		console_service();
+	}
+
+	return 0;
+}
@@ -25,16 +25,23 @@
 
 #include <libbase/console.h>
 #include <libbase/crc.h>
+#include <libbase/dma.h>
+#include <libbase/init_task.h>
 #include <libbase/jsmn.h>
+#include <libbase/profiler.h>
 #include <libbase/progress.h>
+#include <libbase/timebase.h>
 
 #include <libliteeth/udp.h>
 #include <libliteeth/tftp.h>
+#include <libliteeth/etherbone.h>
 
 #include <liblitesdcard/spisdcard.h>
 #include <liblitesdcard/sdcard.h>
 #include <liblitesata/sata.h>
 #include <libfatfs/ff.h>
+#include <libfatfs/diskcache.h>
+#include <libfatfs/fileload.h>
 
 /*-----------------------------------------------------------------------*/
 /* Boot                                                                  */
@@ -44,8 +51,15 @@ extern void boot_helper(unsigned long r1, unsigned long r2, unsigned long r3, un
 
 void __attribute__((noreturn)) boot(unsigned long r1, unsigned long r2, unsigned long r3, unsigned long addr)
 {
+	/* Complete pending device inits before handing over the hardware */
+	init_tasks_wait_all();
+#ifdef PROFILER_AVAILABLE
+	/* Do not leave the sampling Timer0 interrupt to the booted program */
+	profiler_stop();
+#endif
 	printf("Executing booted program at 0x%08lx\n\n", addr);
 	printf("--============= \e[1mLiftoff!\e[0m ===============--\n");
+	fflush(stdout);
 #ifdef CSR_UART_BASE
 	uart_sync();
 #endif
@@ -98,29 +112,26 @@ void romboot(void)
 
 #ifdef CSR_UART_BASE
 
-#define ACK_TIMEOUT_DELAY CONFIG_CLOCK_FREQUENCY/4
-#define CMD_TIMEOUT_DELAY CONFIG_CLOCK_FREQUENCY/4
+#define ACK_TIMEOUT_DELAY_US 250000
+#define CMD_TIMEOUT_DELAY_US 250000
 
-static void timer0_load(unsigned int value) {
-	timer0_en_write(0);
-	timer0_reload_write(0);
+static uint64_t serialboot_deadline(uint64_t us) {
 #ifndef CONFIG_BIOS_NO_DELAYS
-	timer0_load_write(value);
+	return timebase_deadline_us(us);
 #else
-	timer0_load_write(0);
+	return timebase_now();
 #endif
-	timer0_en_write(1);
-	timer0_update_value_write(1);
 }
 
 static int check_ack(void)
 {
 	int recognized;
+	uint64_t deadline;
 	static const char str[SFL_MAGIC_LEN] = SFL_MAGIC_ACK;
 
-	timer0_load(ACK_TIMEOUT_DELAY);
+	deadline = serialboot_deadline(ACK_TIMEOUT_DELAY_US);
 	recognized = 0;
-	while(timer0_value_read()) {
+	while(!timebase_expired(deadline)) {
 		if(uart_read_nonblock()) {
 			char c;
 			c = uart_read();
@@ -137,7 +148,6 @@ static int check_ack(void)
 					recognized = 0;
 			}
 		}
-		timer0_update_value_write(1);
 	}
 	return ACK_TIMEOUT;
 }
@@ -150,6 +160,70 @@ static uint32_t get_uint32(unsigned char* data)
 			  (uint32_t) data[3];
 }
 
+#ifdef CSR_UART_PHY_TUNING_WORD_ADDR
+/* Baudrate upshift (SFL_CMD_BAUDRATE): the host requests a baudrate, the BIOS acknowledges it
+   at the current baudrate and reprograms the PHY. The host then switches its port and confirms
+   the link with a test frame at the new baudrate: without a valid frame before
+   BAUDRATE_TIMEOUT_DELAY_US, the BIOS returns to the previous baudrate. The console baudrate
+   is restored when leaving serialboot. */
+#define BAUDRATE_TIMEOUT_DELAY_US 500000
+#define BAUDRATE_MIN_OVERSAMPLING 16
+
+static uint32_t serialboot_console_tuning_word;
+static uint32_t serialboot_previous_tuning_word;
+
+static void serialboot_set_tuning_word(uint32_t tuning_word)
+{
+	uint32_t current;
+
+	current = uart_phy_tuning_word_read();
+	if (tuning_word == current)
+		return;
+
+	/* Let the pending characters (acks) be transmitted at the current baudrate. */
+	uart_sync();
+	while (!uart_txempty_read());
+	timebase_delay_us(2*((10ULL << 32)/current)*1000000/CONFIG_CLOCK_FREQUENCY + 1);
+
+	uart_phy_tuning_word_write(tuning_word);
+}
+
+static int serialboot_baudrate_supported(uint32_t baudrate)
+{
+	return (baudrate != 0) && ((uint64_t) baudrate*BAUDRATE_MIN_OVERSAMPLING <= CONFIG_CLOCK_FREQUENCY);
+}
+
+/* Returns 1 if the baudrate has been changed */
+static int serialboot_set_baudrate(uint32_t baudrate)
+{
+	uint32_t tuning_word;
+
+	tuning_word = ((uint64_t) baudrate << 32)/CONFIG_CLOCK_FREQUENCY;
+	serialboot_previous_tuning_word = uart_phy_tuning_word_read();
+	serialboot_set_tuning_word(tuning_word);
+	return (tuning_word != serialboot_previous_tuning_word);
+}
+
+static void serialboot_baudrate_init(void)
+{
+	serialboot_console_tuning_word = uart_phy_tuning_word_read();
+}
+
+static void serialboot_baudrate_revert(void)
+{
+	serialboot_set_tuning_word(serialboot_previous_tuning_word);
+}
+
+static void serialboot_baudrate_restore(void)
+{
+	serialboot_set_tuning_word(serialboot_console_tuning_word);
+}
+#else
+static void serialboot_baudrate_init(void) {}
+static void serialboot_baudrate_revert(void) {}
+static void serialboot_baudrate_restore(void) {}
+#endif
+
 #define MAX_FAILURES 256
 
 /* Returns 1 if other boot methods should be tried */
@@ -158,18 +232,14 @@ int serialboot(void)
 	struct sfl_frame frame;
 	int failures;
 	static const char str[SFL_MAGIC_LEN+1] = SFL_MAGIC_REQ;
-	const char *c;
 	int ack_status;
+	int baudrate_pending;
 
 	printf("Booting from serial...\n");
 	printf("Press Q or ESC to abort boot completely.\n");
 
 	/* Send the serialboot "magic" request to Host and wait for ACK_OK */
-	c = str;
-	while(*c) {
-		uart_write(*c);
-		c++;
-	}
+	uart_write_buf(str, SFL_MAGIC_LEN);
 	ack_status = check_ack();
 	if(ack_status == ACK_TIMEOUT) {
 		printf("Timeout\n");
@@ -181,39 +251,46 @@ int serialboot(void)
 	}
 
 	/* Assume ACK_OK */
+	serialboot_baudrate_init();
+	baudrate_pending = 0;
 	failures = 0;
 	while(1) {
-		int i;
+		int i, n;
 		int timeout;
+		uint64_t deadline;
 		int computed_crc;
 		int received_crc;
 
-		/* Get one Frame */
+		/* Get one Frame (length byte first, then the rest of the frame as blocks) */
 		i = 0;
 		timeout = 1;
-		while((i == 0) || timer0_value_read()) {
-			if (uart_read_nonblock()) {
-				if (i == 0) {
-					timer0_load(CMD_TIMEOUT_DELAY);
-					frame.payload_length = uart_read();
-				}
-				if (i == 1) frame.crc[0] = uart_read();
-				if (i == 2) frame.crc[1] = uart_read();
-				if (i == 3) frame.cmd    = uart_read();
-				if (i >= 4) {
-					frame.payload[i-4] = uart_read();
-					if (i == (frame.payload_length + 4 - 1)) {
-						timeout = 0;
-						break;
-					}
+		deadline = 0;
+#ifdef BAUDRATE_TIMEOUT_DELAY_US
+		/* After a baudrate change, wait for the host test frame for a limited time. */
+		if (baudrate_pending)
+			deadline = serialboot_deadline(BAUDRATE_TIMEOUT_DELAY_US);
+#endif
+		while(((i == 0) && !baudrate_pending) || !timebase_expired(deadline)) {
+			n = uart_read_buf((char *) &frame + i, (i == 0) ? 1 : (frame.payload_length + 4 - i));
+			if (n) {
+				if (i == 0)
+					deadline = serialboot_deadline(CMD_TIMEOUT_DELAY_US);
+				i += n;
+				if ((i > 4) && (i == (frame.payload_length + 4))) {
+					timeout = 0;
+					break;
 				}
-				i++;
 			}
-			timer0_update_value_write(1);
 		}
 
 		/* Check Timeout */
 		if (timeout) {
+			/* Return to the previous baudrate if the new one is not working */
+			if (baudrate_pending) {
+				baudrate_pending = 0;
+				serialboot_baudrate_revert();
+				continue;
+			}
 			/* Acknowledge the Timeout and continue with a new frame */
 			uart_write(SFL_ACK_ERROR);
 			continue;
@@ -223,18 +300,28 @@ int serialboot(void)
 		received_crc = ((int)frame.crc[0] << 8)|(int)frame.crc[1];
 		computed_crc = crc16(&frame.cmd, frame.payload_length + 1);
 		if(computed_crc != received_crc) {
+			/* Return to the previous baudrate if the new one is not working */
+			if (baudrate_pending) {
+				baudrate_pending = 0;
+				serialboot_baudrate_revert();
+				continue;
+			}
 			/* Acknowledge the CRC error */
 			uart_write(SFL_ACK_CRCERROR);
 
 			/* Increment failures and exit when max is reached */
 			failures++;
 			if(failures == MAX_FAILURES) {
+				serialboot_baudrate_restore();
 				printf("Too many consecutive errors, aborting");
 				return 1;
 			}
 			continue;
 		}
 
+		/* Valid Frame: the new baudrate (if any) is working */
+		baudrate_pending = 0;
+
 		/* Execute Frame CMD */
 		switch(frame.cmd) {
 			/* On SFL_CMD_ABORT ... */
@@ -243,6 +330,7 @@ int serialboot(void)
 				failures = 0;
 				/* Acknowledge and exit */
 				uart_write(SFL_ACK_SUCCESS);
+				serialboot_baudrate_restore();
 				return 1;
 
 			/* On SFL_CMD_LOAD... */
@@ -269,10 +357,32 @@ int serialboot(void)
 
 				/* Acknowledge and jump */
 				uart_write(SFL_ACK_SUCCESS);
+				serialboot_baudrate_restore();
 				jump_addr = get_uint32(&frame.payload[0]);
 				boot(0, 0, 0, jump_addr);
 				break;
 			}
+#ifdef CSR_UART_PHY_TUNING_WORD_ADDR
+			/* On SFL_CMD_BAUDRATE... */
+			case SFL_CMD_BAUDRATE: {
+				uint32_t baudrate;
+
+				/* Reset failures */
+				failures = 0;
+
+				/* Reject unsupported baudrates */
+				baudrate = get_uint32(&frame.payload[0]);
+				if ((frame.payload_length < 4) || !serialboot_baudrate_supported(baudrate)) {
+					uart_write(SFL_ACK_ERROR);
+					break;
+				}
+
+				/* Acknowledge (at the current baudrate) and switch */
+				uart_write(SFL_ACK_SUCCESS);
+				baudrate_pending = serialboot_set_baudrate(baudrate);
+				break;
+			}
+#endif
 			default:
 				/* Increment failures */
 				failures++;
@@ -282,6 +392,7 @@ int serialboot(void)
 
 				/* Increment failures and exit when max is reached */
 				if(failures == MAX_FAILURES) {
+					serialboot_baudrate_restore();
 					printf("Too many consecutive errors, aborting");
 					return 1;
 				}
@@ -327,6 +438,7 @@ const char *filename, char *buffer)
 {
 	int size;
 	printf("Copying %s to %p... ", filename, buffer);
+	fflush(stdout);
 	size = tftp_get(ip, server_port, filename, buffer);
 	if(size > 0)
 		printf("(%d bytes)", size);
@@ -538,6 +650,52 @@ static void netboot_from_bin(const char * filename, unsigned int ip, unsigned sh
 }
 #endif
 
+#ifndef NET_SEND_CHUNK
+#define NET_SEND_CHUNK 1024
+#endif
+
+/* Send a buffer to the remote IP as UDP datagrams (src/dst port = port). */
+int net_send(unsigned short port, const void *data, unsigned int length)
+{
+	unsigned int ip;
+	unsigned int n;
+	const char *c = data;
+
+	ip = IPTOINT(remote_ip[0], remote_ip[1], remote_ip[2], remote_ip[3]);
+	udp_start(macadr, IPTOINT(local_ip[0], local_ip[1], local_ip[2], local_ip[3]));
+	if (!udp_arp_resolve(ip))
+		return -1;
+	while (length) {
+		n = min(length, NET_SEND_CHUNK);
+		memcpy(udp_get_tx_buffer(), c, n);
+		if (!udp_send(port, port, n))
+			return -1;
+		c      += n;
+		length -= n;
+	}
+	return 0;
+}
+
+/* Serve Etherbone memory reads/writes on UDP port until a key is pressed. */
+void net_etherbone(unsigned short port)
+{
+	const struct etherbone_stats *stats;
+
+	printf("Etherbone server on %d.%d.%d.%d:%d, press any key to stop...\n",
+		local_ip[0], local_ip[1], local_ip[2], local_ip[3], port);
+
+	udp_start(macadr, IPTOINT(local_ip[0], local_ip[1], local_ip[2], local_ip[3]));
+	etherbone_start(port);
+	while (!readchar_nonblock())
+		udp_service();
+	getchar();
+	etherbone_stop();
+
+	stats = etherbone_get_stats();
+	printf("Etherbone: %u packets (%u probes), %u records, %u words read, %u words written, %u errors\n",
+		stats->packets, stats->probes, stats->records, stats->reads, stats->writes, stats->errors);
+}
+
 void netboot(int nb_params, char **params)
 {
 	unsigned int ip;
@@ -614,6 +772,16 @@ static int copy_image_from_flash_to_ram(unsigned int flash_address, unsigned lon
 		printf("Copying 0x%08x to 0x%08lx (%d bytes)...\n", flash_address, ram_address, length);
 		offset = 0;
 		init_progression_bar(length);
+#ifdef DMA_AVAILABLE
+		/* Copy the bus-aligned part with the DMA engine, the remainder with the CPU. */
+		if (dma_memcpy_start((void *) ram_address, (void *) flash_address + 8, length & ~(DMA_WORD_BYTES - 1))) {
+			while (!dma_done())
+				show_progress(dma_progress());
+			dma_wait();
+			offset = length & ~(DMA_WORD_BYTES - 1);
+			length -= offset;
+		}
+#endif
 		while (length > 0) {
 			uint32_t chunk_length;
 			chunk_length = min(length, 0x8000); /* 32KB chunks */
@@ -663,51 +831,6 @@ void flashboot(void)
 
 #if defined(CSR_SPISDCARD_BASE) || defined(CSR_SDCARD_CORE_BASE)
 
-static int copy_file_from_sdcard_to_ram(const char * filename, unsigned long ram_address)
-{
-	FRESULT fr;
-	FATFS fs;
-	FIL file;
-	uint32_t br;
-	uint32_t offset;
-	unsigned long length;
-
-	fr = f_mount(&fs, "", 1);
-	if (fr != FR_OK)
-		return 0;
-	fr = f_open(&file, filename, FA_READ);
-	if (fr != FR_OK) {
-		printf("%s file not found.\n", filename);
-		f_mount(0, "", 0);
-		return 0;
-	}
-
-	length = f_size(&file);
-	printf("Copying %s to 0x%08lx (%ld bytes)...\n", filename, ram_address, length);
-	init_progression_bar(length);
-	offset = 0;
-	for (;;) {
-		fr = f_read(&file, (void*) ram_address + offset,  0x8000, (UINT *)&br);
-		if (fr != FR_OK) {
-			printf("file read error.\n");
-			f_close(&file);
-			f_mount(0, "", 0);
-			return 0;
-		}
-		if (br == 0)
-			break;
-		offset += br;
-		show_progress(offset);
-	}
-	show_progress(offset);
-	printf("\n");
-
-	f_close(&file);
-	f_mount(0, "", 0);
-
-	return 1;
-}
-
 static void sdcardboot_from_json(const char * filename)
 {
 	FRESULT fr;
@@ -786,7 +909,7 @@ static void sdcardboot_from_json(const char * filename)
 				boot_r3 = strtoul(json_value, NULL, 0);
 			/* Copy Image from SDCard to address */
 			} else {
-				result = copy_file_from_sdcard_to_ram(json_name, strtoul(json_value, NULL, 0));
+				result = fatfs_copy_file_to_ram(json_name, strtoul(json_value, NULL, 0));
 				if (result == 0)
 					return;
 				image_found = 1;
@@ -805,7 +928,7 @@ static void sdcardboot_from_json(const char * filename)
 static void sdcardboot_from_bin(const char * filename)
 {
 	uint32_t result;
-	result = copy_file_from_sdcard_to_ram(filename, MAIN_RAM_BASE);
+	result = fatfs_copy_file_to_ram(filename, MAIN_RAM_BASE);
 	if (result == 0)
 		return;
 	boot(0, 0, 0, MAIN_RAM_BASE);
@@ -822,6 +945,7 @@ void sdcardboot(void)
 	printf("Booting from SDCard in SD-Mode...\n");
 	fatfs_set_ops_sdcard();		/* use sdcard disk access ops */
 #endif
+	fatfs_set_ops_cache();		/* insert disk cache (when configured) */
 
 	/* Boot from boot.json */
 	printf("Booting from boot.json...\n");
@@ -844,51 +968,6 @@ void sdcardboot(void)
 
 #if defined(CSR_SATA_SECTOR2MEM_BASE)
 
-static int copy_file_from_sata_to_ram(const char * filename, unsigned long ram_address)
-{
-	FRESULT fr;
-	FATFS fs;
-	FIL file;
-	uint32_t br;
-	uint32_t offset;
-	unsigned long length;
-
-	fr = f_mount(&fs, "", 1);
-	if (fr != FR_OK)
-		return 0;
-	fr = f_open(&file, filename, FA_READ);
-	if (fr != FR_OK) {
-		printf("%s file not found.\n", filename);
-		f_mount(0, "", 0);
-		return 0;
-	}
-
-	length = f_size(&file);
-	printf("Copying %s to 0x%08lx (%ld bytes)...\n", filename, ram_address, length);
-	init_progression_bar(length);
-	offset = 0;
-	for (;;) {
-		fr = f_read(&file, (void*) ram_address + offset,  0x8000, (UINT *) &br);
-		if (fr != FR_OK) {
-			printf("file read error.\n");
-			f_close(&file);
-			f_mount(0, "", 0);
-			return 0;
-		}
-		if (br == 0)
-			break;
-		offset += br;
-		show_progress(offset);
-	}
-	show_progress(offset);
-	printf("\n");
-
-	f_close(&file);
-	f_mount(0, "", 0);
-
-	return 1;
-}
-
 static void sataboot_from_json(const char * filename)
 {
 	FRESULT fr;
@@ -967,7 +1046,7 @@ static void sataboot_from_json(const char * filename)
 				boot_r3 = strtoul(json_value, NULL, 0);
 			/* Copy Image from SDCard to address */
 			} else {
-				result = copy_file_from_sata_to_ram(json_name, strtoul(json_value, NULL, 0));
+				result = fatfs_copy_file_to_ram(json_name, strtoul(json_value, NULL, 0));
 				if (result == 0)
 					return;
 				image_found = 1;
@@ -985,7 +1064,7 @@ static void sataboot_from_json(const char * filename)
 static void sataboot_from_bin(const char * filename)
 {
 	uint32_t result;
-	result = copy_file_from_sata_to_ram(filename, MAIN_RAM_BASE);
+	result = fatfs_copy_file_to_ram(filename, MAIN_RAM_BASE);
 	if (result == 0)
 		return;
 	boot(0, 0, 0, MAIN_RAM_BASE);
@@ -995,6 +1074,7 @@ void sataboot(void)
 {
 	printf("Booting from SATA...\n");
 	fatfs_set_ops_sata();		/* use sata disk access ops */
+	fatfs_set_ops_cache();		/* insert disk cache (when configured) */
 
 	/* Boot from boot.json */
 	printf("Booting from boot.json...\n");
@@ -2,15 +2,22 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <system.h>
+#include <irq.h>
 
 #include <libbase/crc.h>
+#include <libbase/irq_stats.h>
+#include <libbase/profiler.h>
+#include <libbase/timebase.h>
+#include <libbase/trace.h>
 
 #include <generated/csr.h>
 
 #include "../command.h"
 #include "../helpers.h"
 #include "../sim_debug.h"
+#include "../boot.h"
 
 /**
  * Command "help"
@@ -75,8 +82,7 @@ static void uptime_handler(int nb_params, char **params)
 {
 	unsigned long uptime;
 
-	timer0_uptime_latch_write(1);
-	uptime = timer0_uptime_cycles_read();
+	uptime = timebase_now();
 	printf("Uptime: %ld sys_clk cycles / %ld seconds",
 		uptime,
 		uptime/CONFIG_CLOCK_FREQUENCY
@@ -86,6 +92,190 @@ static void uptime_handler(int nb_params, char **params)
 define_command(uptime, uptime_handler, "Uptime of the system since power-up", SYSTEM_CMDS);
 #endif
 
+/**
+ * Command "boot_time"
+ *
+ * Boot time breakdown recorded by the tracepoints
+ *
+ */
+static void boot_time_handler(int nb_params, char **params)
+{
+	trace_summary();
+}
+
+define_command(boot_time, boot_time_handler, "Boot time breakdown", SYSTEM_CMDS);
+
+/**
+ * Command "prof"
+ *
+ * Statistical profiler (samples the PC from a periodic Timer0 interrupt)
+ *
+ */
+#ifdef PROFILER_AVAILABLE
+
+#ifndef PROFILER_BIOS_BUCKETS
+#define PROFILER_BIOS_BUCKETS 256
+#endif
+
+#ifndef PROFILER_UDP_PORT
+#define PROFILER_UDP_PORT 6070
+#endif
+
+extern char _ftext[], _etext[];
+
+static uint32_t prof_hist[PROFILER_BIOS_BUCKETS];
+
+static void prof_emit_uart(const char *line, void *arg)
+{
+	fputs(line, stdout);
+}
+
+#ifdef CSR_ETHMAC_BASE
+struct prof_udp {
+	unsigned short port;
+	unsigned int   len;
+	char           buf[1024];
+};
+
+static void prof_emit_udp(const char *line, void *arg)
+{
+	struct prof_udp *udp = arg;
+	unsigned int n = strlen(line);
+
+	/* Send complete lines only, one datagram per buffer */
+	if (udp->len + n > sizeof(udp->buf)) {
+		net_send(udp->port, udp->buf, udp->len);
+		udp->len = 0;
+	}
+	memcpy(&udp->buf[udp->len], line, n);
+	udp->len += n;
+	if (strcmp(line, "prof: end\n") == 0)
+		net_send(udp->port, udp->buf, udp->len);
+}
+#endif
+
+static void prof_handler(int nb_params, char **params)
+{
+	char *c;
+	unsigned long lo, hi;
+	unsigned int rate;
+
+	if (nb_params < 1) {
+		printf("prof start [<rate>] [<lo> <hi>]\n");
+		printf("prof stop|reset|dump\n");
+#ifdef CSR_ETHMAC_BASE
+		printf("prof send [<port>]");
+#endif
+		return;
+	}
+
+	if (strcmp(params[0], "start") == 0) {
+		rate = PROFILER_DEFAULT_RATE;
+		lo   = (unsigned long) _ftext;
+		hi   = (unsigned long) _etext;
+		if (nb_params > 1) {
+			rate = strtoul(params[1], &c, 0);
+			if (*c != 0) {
+				printf("Incorrect rate");
+				return;
+			}
+		}
+		if (nb_params > 3) {
+			lo = strtoul(params[2], &c, 0);
+			if (*c != 0) {
+				printf("Incorrect lo");
+				return;
+			}
+			hi = strtoul(params[3], &c, 0);
+			if (*c != 0) {
+				printf("Incorrect hi");
+				return;
+			}
+		}
+		if (profiler_start(prof_hist, PROFILER_BIOS_BUCKETS, lo, hi, rate) != 0) {
+			printf("Profiler start failed");
+			return;
+		}
+		printf("Profiling 0x%08lx-0x%08lx at %u Hz (%u bytes/bucket)",
+			lo, hi, profiler_get()->rate, 1 << profiler_get()->shift);
+	} else if (strcmp(params[0], "stop") == 0) {
+		profiler_stop();
+	} else if (strcmp(params[0], "reset") == 0) {
+		profiler_reset();
+	} else if (strcmp(params[0], "dump") == 0) {
+		profiler_dump(prof_emit_uart, NULL);
+#ifdef CSR_ETHMAC_BASE
+	} else if (strcmp(params[0], "send") == 0) {
+		static struct prof_udp udp;
+		udp.port = PROFILER_UDP_PORT;
+		udp.len  = 0;
+		if (nb_params > 1) {
+			udp.port = strtoul(params[1], &c, 0);
+			if (*c != 0) {
+				printf("Incorrect port");
+				return;
+			}
+		}
+		profiler_dump(prof_emit_udp, &udp);
+#endif
+	} else
+		printf("Unknown prof command: %s", params[0]);
+}
+
+define_command(prof, prof_handler, "Statistical profiler", SYSTEM_CMDS);
+#endif
+
+/**
+ * Command "irq_stats"
+ *
+ * Per-IRQ handler calls, entry latency and duration (sys_clk cycles, log2 histograms)
+ *
+ */
+#ifdef IRQ_STATS_AVAILABLE
+static void irq_stats_print_hist(const char *name, const uint32_t *hist)
+{
+	int i;
+
+	printf(" %s", name);
+	for (i = 0; i < IRQ_STATS_BINS; i++)
+		printf(" %u", (unsigned int) hist[i]);
+}
+
+static void irq_stats_handler(int nb_params, char **params)
+{
+	struct irq_stats s;
+	unsigned int irq, ie;
+
+	if (nb_params > 0) {
+		if (strcmp(params[0], "reset") != 0) {
+			printf("irq_stats [reset]");
+			return;
+		}
+		irq_stats_reset();
+		return;
+	}
+
+	/* One line per IRQ: irq <n> count <c> lat_max <cycles> dur_max <cycles> dur_avg <cycles>
+	   lat_hist <bins> dur_hist <bins> (bin 0: 0 cycles, bin n: [2^(n-1), 2^n) cycles). */
+	for (irq = 0; irq < CONFIG_CPU_INTERRUPTS; irq++) {
+		ie = irq_getie();
+		irq_setie(0);
+		memcpy(&s, irq_stats_get(irq), sizeof(s));
+		irq_setie(ie);
+		if (s.count == 0)
+			continue;
+		printf("irq %u count %u lat_max %u dur_max %u dur_avg %u", irq,
+			(unsigned int) s.count, (unsigned int) s.latency_max, (unsigned int) s.duration_max,
+			(unsigned int) (s.duration_total/s.count));
+		irq_stats_print_hist("lat_hist", s.latency_hist);
+		irq_stats_print_hist("dur_hist", s.duration_hist);
+		printf("\n");
+	}
+}
+
+define_command(irq_stats, irq_stats_handler, "Interrupt latency/duration statistics", SYSTEM_CMDS);
+#endif
+
 /**
  * Command "crc"
  *
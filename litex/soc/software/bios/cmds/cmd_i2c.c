@@ -161,6 +161,29 @@ static void i2c_scan_handler(int nb_params, char **params)
 }
 define_command(i2c_scan, i2c_scan_handler, "Scan for I2C slaves", I2C_CMDS);
 
+/**
+ * Command "i2c_freq"
+ *
+ * Get/Set I2C bus frequency
+ *
+ */
+static void i2c_freq_handler(int nb_params, char **params)
+{
+	unsigned int freq_hz;
+	char *c;
+
+	if (nb_params == 1) {
+		freq_hz = strtoul(params[0], &c, 0);
+		if ((*c != 0) || (freq_hz == 0) || (freq_hz > I2C_FREQ_FAST_PLUS)) {
+			printf("Incorrect frequency");
+			return;
+		}
+		i2c_set_freq(freq_hz);
+	}
+	printf("I2C frequency: %u Hz\n", i2c_get_freq());
+}
+define_command(i2c_freq, i2c_freq_handler, "Get/Set I2C frequency", I2C_CMDS);
+
 /**
  * Command "i2c_dev"
  *
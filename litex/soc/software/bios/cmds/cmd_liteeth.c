@@ -7,6 +7,7 @@
 #include <generated/soc.h>
 
 #include <libliteeth/mdio.h>
+#include <libliteeth/etherbone.h>
 
 #include "../command.h"
 #include "../helpers.h"
@@ -193,3 +194,28 @@ static void eth_mac_addr_handler(int nb_params, char **params)
 }
 define_command(eth_mac_addr, eth_mac_addr_handler, "Set the mac address", LITEETH_CMDS);
 #endif
+
+/**
+ * Command "eth_etherbone"
+ *
+ * Etherbone (UDP) memory server, for litex_server --udp on SoCs without hardware Etherbone
+ * (accepts --udp-max-burst 255 --udp-max-records 0).
+ *
+ */
+#ifdef CSR_ETHMAC_BASE
+static void eth_etherbone_handler(int nb_params, char **params)
+{
+	unsigned int port = ETHERBONE_PORT;
+	char *c;
+
+	if (nb_params > 0) {
+		port = strtoul(params[0], &c, 0);
+		if ((*c != 0) || (port == 0) || (port > 0xffff)) {
+			printf("Incorrect port");
+			return;
+		}
+	}
+	net_etherbone(port);
+}
+define_command(eth_etherbone, eth_etherbone_handler, "Etherbone server (litex_server --udp)", LITEETH_CMDS);
+#endif
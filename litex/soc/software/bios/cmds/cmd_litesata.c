@@ -20,6 +20,7 @@
 static void sata_init_handler(int nb_params, char **params)
 {
 	printf("Initialize SATA... ");
+	fflush(stdout);
 	if (sata_init(1))
 		printf("Successful.\n");
 	else
@@ -180,69 +181,18 @@ define_command(sata_mem2sec, sata_mem2sec_handler, "Write SATA from memory", LIT
 /* LiteSATA read/write test */
 #if defined(CSR_SATA_SECTOR2MEM_BASE) && defined(CSR_SATA_MEM2SECTOR_BASE)
 #include <string.h>
-static int sata_rd(uint32_t sector, uint32_t count, void *mem)
-{
-	uint32_t done_cnt;
-	uint8_t retry_cnt;
-
-	for (retry_cnt = 8; retry_cnt > 0; retry_cnt--) {
-		sata_sector2mem_base_write((uint64_t)(uintptr_t)mem);
-		sata_sector2mem_sector_write(sector);
-		sata_sector2mem_nsectors_write(count);
-		sata_sector2mem_start_write(1);
-		for (done_cnt = 0x0000ffff; done_cnt > 0; done_cnt --) {
-			if ((sata_sector2mem_done_read() & 0x1) != 0) {
-				if ((sata_sector2mem_error_read() & 0x1) == 0)
-					return 0;
-				else {
-					printf("sata_rd: op failed, retry\n");
-					break;
-				}
-			}
-		}
-		printf("sata_rd: op timeout (done_cnt)\n");
-		busy_wait_us(10);
-	}
-	printf("sata_rd: out of retries\n");
-	return -1;
-}
-
 static int sata_rd_1(uint32_t sector, uint32_t count, void *mem)
 {
 	while(count--) {
-		sata_read(sector++, 1, mem);
+		if (sata_read(sector++, 1, mem) != SATA_XFER_DONE) {
+			printf("sata_rd_1: out of retries\n");
+			return -1;
+		}
 		mem += 512;
 	}
 	return 0;
 }
 
-static int sata_wr(uint32_t sector, uint32_t count, void *mem)
-{
-	uint32_t done_cnt;
-	uint8_t retry_cnt;
-
-	for (retry_cnt = 8; retry_cnt > 0; retry_cnt--) {
-		sata_mem2sector_base_write((uint64_t)(uintptr_t)mem);
-		sata_mem2sector_sector_write(sector);
-		sata_mem2sector_nsectors_write(count);
-		sata_mem2sector_start_write(1);
-		for (done_cnt = 0x000fffff; done_cnt > 0; done_cnt --) {
-			if ((sata_mem2sector_done_read() & 0x1) != 0) {
-				if ((sata_mem2sector_error_read() & 0x1) == 0)
-					return 0;
-				else {
-					printf("sata_wr: op failed, retry\n");
-					break;
-				}
-			}
-		}
-		printf("sata_wr: op timeout (done_cnt)\n");
-		busy_wait_us(10);
-	}
-	printf("sata_wr: out of retries\n");
-	return -1;
-}
-
 static int sata_mem_cmp(char *mem1, char *mem2, uint32_t count)
 {
 	uint32_t i, j;
@@ -258,10 +208,14 @@ static int sata_mem_cmp(char *mem1, char *mem2, uint32_t count)
 	return 0;
 }
 
+/* Readback is done in chunks, the next chunk being read while the previous one is compared. */
+#define SATA_RWTEST_CHUNK 128
+
 static int sata_do_rwtest(uint32_t sec, uint32_t cnt, char *mem, char *str)
 {
 	char *c = str;
-	int i;
+	char *rd = mem + 512*cnt;
+	uint32_t i, n;
 
 	if (c != NULL) {
 		for (i = 0; i < 512 * cnt; i++) {
@@ -270,14 +224,29 @@ static int sata_do_rwtest(uint32_t sec, uint32_t cnt, char *mem, char *str)
 				c = str;
 		}
 	}
-	if (sata_wr(sec, cnt, mem) < 0)
+	if (sata_write(sec, cnt, (uint8_t *)mem) != SATA_XFER_DONE) {
+		printf("sata_wr: out of retries\n");
 		return -1;
-	if (sata_rd(sec, cnt, mem + 512*cnt) < 0)
-		return -1;
-	if (sata_mem_cmp(mem, mem + 512*cnt, cnt) == 0)
+	}
+
+	n = min(cnt, SATA_RWTEST_CHUNK);
+	sata_read_submit(sec, n, (uint8_t *)rd);
+	for (i = 0; i < cnt; i += n) {
+		n = min(cnt - i, SATA_RWTEST_CHUNK);
+		if (sata_read_wait() != SATA_XFER_DONE) {
+			printf("sata_rd: out of retries\n");
+			return -1;
+		}
+		if (i + n < cnt)
+			sata_read_submit(sec + i + n, min(cnt - i - n, SATA_RWTEST_CHUNK), (uint8_t *)rd + 512*(i + n));
+		if (sata_mem_cmp(mem + 512*i, rd + 512*i, n) != 0)
+			break;
+	}
+	if (i >= cnt)
 		return 0;
+	sata_read_wait();
 	printf("compare failed, retrying with single-sector reads:\n");
-	return sata_rd_1(sec, cnt, mem + 512*cnt);
+	return sata_rd_1(sec, cnt, rd);
 }
 
 static void sata_rwtest_handler(int nb_params, char **params)
@@ -36,6 +36,7 @@ define_command(sdcard_detect, sdcard_detect_handler, "Detect SDCard", LITESDCARD
 static void sdcard_init_handler(int nb_params, char **params)
 {
 	printf("Initialize SDCard... ");
+	fflush(stdout);
 	if (sdcard_init())
 		printf("Successful.\n");
 	else
@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <libbase/dma.h>
 #include <libbase/memtest.h>
 
 #include <generated/csr.h>
@@ -108,6 +109,16 @@ static void mem_write_handler(int nb_params, char **params)
 	if (nb_params == 4)
 		size = strtoul(params[3], &c, 0);
 
+	/* Large fills (framebuffers, etc.) with the DMA engine when present. */
+	if (((size == 1) || (size == 2) || (size == 4)) && (count*size >= DMA_MIN_SIZE)) {
+		uint32_t pattern = (size == 1) ? 0x01010101u*(uint8_t) value :
+		                   (size == 2) ? 0x00010001u*(uint16_t) value : value;
+		if (dma_fill_start(addr, pattern, count*size)) {
+			dma_wait();
+			return;
+		}
+	}
+
 	for (i = 0; i < count; i++) {
 		switch (size) {
 		case 1:
@@ -172,6 +183,12 @@ static void mem_copy_handler(int nb_params, char **params)
 		}
 	}
 
+	/* Large copies with the DMA engine when present. */
+	if ((count*sizeof(*dstaddr) >= DMA_MIN_SIZE) && dma_memcpy_start(dstaddr, srcaddr, count*sizeof(*dstaddr))) {
+		dma_wait();
+		return;
+	}
+
 	for (i = 0; i < count; i++)
 		*dstaddr++ = *srcaddr++;
 }
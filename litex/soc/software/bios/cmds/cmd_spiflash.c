@@ -2,20 +2,26 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <generated/csr.h>
+#include <generated/mem.h>
+#include <generated/soc.h>
 
 #include "../command.h"
 #include "../helpers.h"
 
 #include <libbase/progress.h>
 #include <liblitespi/spiflash.h>
+#include <liblitesdcard/spisdcard.h>
+#include <liblitesdcard/sdcard.h>
 #include <libfatfs/ff.h>
 
 /**
  * Command "flash_write"
  *
- * Write data from a memory buffer to SPI flash
+ * Write data from a memory buffer to SPI flash. Partially written sectors that need an erase
+ * require a 4KB read-modify-write buffer (rmw_addr, clobbered, must not overlap the data).
  *
  */
 #if (defined CSR_SPIFLASH_CORE_MASTER_CS_ADDR)
@@ -25,9 +31,10 @@ static void flash_write_handler(int nb_params, char **params)
 	unsigned int addr;
 	unsigned int mem_addr;
 	unsigned int count;
+	unsigned char *rmw_buf = NULL;
 
 	if (nb_params < 2) {
-		printf("flash_write <offset> <mem_addr> [count (bytes)]");
+		printf("flash_write <offset> <mem_addr> [count (bytes)] [rmw_addr]");
 		return;
 	}
 
@@ -53,28 +60,224 @@ static void flash_write_handler(int nb_params, char **params)
 		}
 	}
 
-	spiflash_write_stream(addr, (unsigned char *)mem_addr, count);
+	if (nb_params > 3) {
+		rmw_buf = (unsigned char *)strtoul(params[3], &c, 0);
+		if (*c != 0) {
+			printf("Incorrect rmw_addr");
+			return;
+		}
+	}
+
+	spiflash_write_range(addr, (unsigned char *)mem_addr, count, rmw_buf);
+}
+
+define_command(flash_write, flash_write_handler, "Write to flash (erasing when required)", SPIFLASH_CMDS);
+
+#if defined(CSR_SPISDCARD_BASE) || defined(CSR_SDCARD_CORE_BASE)
+/* The file is first compared with the flash to find the 4KB sectors that need an erase (as
+   spiflash_write_range), then copied through a ring of buffers: SD reads fill the ring while the
+   flash erases ahead these sectors (with 64KB/32KB erases when possible) and programs/verifies the
+   data already read (skipping pages already equal to it), the flash being polled between each step.
+   The ring (64KB, clobbered) is at the top of Main RAM (below the FatFs disk cache when it is
+   there) or at ring_addr; without Main RAM, a small ring on the stack is used. The part of the last
+   sector beyond the end of the file is lost when this sector needs an erase. */
+#define FLASH_FROM_SDCARD_SLOT_SIZE       512
+#define FLASH_FROM_SDCARD_SLOTS           2
+#define FLASH_FROM_SDCARD_EXT_SLOT_SIZE   4096
+#define FLASH_FROM_SDCARD_EXT_SLOTS       16
+#define FLASH_FROM_SDCARD_EXT_RING_SIZE   (FLASH_FROM_SDCARD_EXT_SLOTS*FLASH_FROM_SDCARD_EXT_SLOT_SIZE)
+
+#ifdef MAIN_RAM_BASE
+#if defined(CONFIG_FATFS_CACHE_BASE) && defined(CONFIG_FATFS_CACHE_SIZE) && \
+	(CONFIG_FATFS_CACHE_BASE < MAIN_RAM_BASE + MAIN_RAM_SIZE) && \
+	(CONFIG_FATFS_CACHE_BASE + CONFIG_FATFS_CACHE_SIZE > MAIN_RAM_BASE + MAIN_RAM_SIZE - FLASH_FROM_SDCARD_EXT_RING_SIZE)
+#define FLASH_FROM_SDCARD_RING_ADDR (CONFIG_FATFS_CACHE_BASE - FLASH_FROM_SDCARD_EXT_RING_SIZE)
+#else
+#define FLASH_FROM_SDCARD_RING_ADDR (MAIN_RAM_BASE + MAIN_RAM_SIZE - FLASH_FROM_SDCARD_EXT_RING_SIZE)
+#endif
+#endif
+
+#ifdef SPIFLASH_SIZE
+#define FLASH_FROM_SDCARD_SECTORS (SPIFLASH_SIZE/SPI_FLASH_SECTOR_SIZE)
+#else
+#define FLASH_FROM_SDCARD_SECTORS 4096 /* 16MB */
+#endif
+
+/* Sectors needing an erase (1 bit per sector). */
+static uint32_t flash_from_sdcard_erase_map[(FLASH_FROM_SDCARD_SECTORS + 31)/32];
+
+static int flash_from_sdcard_needs_erase(uint32_t offset)
+{
+	uint32_t sector = offset/SPI_FLASH_SECTOR_SIZE;
+	return (flash_from_sdcard_erase_map[sector/32] >> (sector%32)) & 1;
+}
+
+/* Compare the file with the flash (through buf, slot_size bytes) and fill the erase map. */
+static int flash_from_sdcard_compare(FIL *file, unsigned long length, uint8_t *buf, uint32_t slot_size)
+{
+	FRESULT fr;
+	uint32_t br;
+	uint32_t offset;
+	uint32_t sector;
+
+	memset(flash_from_sdcard_erase_map, 0, sizeof(flash_from_sdcard_erase_map));
+	spiflash_mmap_sync();
+	offset = 0;
+	while (offset < length) {
+		fr = f_read(file, buf, min(length - offset, slot_size), (UINT *)&br);
+		if ((fr != FR_OK) || (br == 0))
+			return -1;
+		if (spiflash_sector_state(offset, buf, br) == SPIFLASH_SECTOR_ERASE) {
+			/* Sector needs an erase: skip the rest of its data. */
+			sector = offset/SPI_FLASH_SECTOR_SIZE;
+			flash_from_sdcard_erase_map[sector/32] |= 1u << (sector%32);
+			offset = (sector + 1)*SPI_FLASH_SECTOR_SIZE;
+			if ((offset < length) && (f_lseek(file, offset) != FR_OK))
+				return -1;
+		} else
+			offset += br;
+	}
+	return (f_lseek(file, 0) == FR_OK) ? 0 : -1;
+}
+
+/* Largest erase block at offset (up to end) whose sectors all need an erase. */
+static uint32_t flash_from_sdcard_erase_size(uint32_t offset, uint32_t end)
+{
+	uint32_t size;
+	uint32_t i;
+
+	size = spiflash_erase_block_size(offset, end - offset);
+	while (size > SPI_FLASH_SECTOR_SIZE) {
+		for (i=0; i<size; i+=SPI_FLASH_SECTOR_SIZE)
+			if (!flash_from_sdcard_needs_erase(offset + i))
+				break;
+		if (i == size)
+			break;
+		size = (size == 64*1024) ? 32*1024 : SPI_FLASH_SECTOR_SIZE;
+	}
+	return size;
 }
 
-define_command(flash_write, flash_write_handler, "Write to flash", SPIFLASH_CMDS);
+/* Copy the file through the ring (erase map filled by flash_from_sdcard_compare). */
+static void flash_from_sdcard_copy(FIL *file, unsigned long length, uint8_t *ring, uint32_t slot_size,
+	uint32_t ring_size)
+{
+	FRESULT fr;
+	uint32_t br;
+	uint32_t end;
+	uint32_t rd_offset; /* Data read from the SDCard. */
+	uint32_t er_offset; /* Flash erased (or not needing an erase). */
+	uint32_t pg_offset; /* Flash programmed. */
+	uint32_t vf_offset; /* Flash verified (and ring slot released). */
+	uint32_t n;
+	int sync;
+	unsigned int nerased, nprogrammed;
+
+	end = (length + SPI_FLASH_SECTOR_SIZE - 1) & ~(SPI_FLASH_SECTOR_SIZE - 1);
+	init_progression_bar(length);
+	rd_offset   = 0;
+	er_offset   = 0;
+	pg_offset   = 0;
+	vf_offset   = 0;
+	sync        = 0;
+	nerased     = 0;
+	nprogrammed = 0;
+	while (vf_offset < length) {
+		/* Flash: start the next step as soon as the previous one is done. */
+		if (!spiflash_busy()) {
+			n = min(length - vf_offset, slot_size);
+			/* Verify programmed slot and release it. */
+			if (pg_offset >= vf_offset + n) {
+				spiflash_mmap_sync();
+				sync = 0;
+				if (memcmp((void *)(SPIFLASH_BASE + vf_offset),
+					ring + (vf_offset % ring_size), n) != 0) {
+					printf("\nError: verify failed at 0x%08lx\n", vf_offset);
+					break;
+				}
+				vf_offset += n;
+				show_progress(vf_offset);
+			/* Program next page (in erased area, when fully read), unless already equal. */
+			} else if ((pg_offset < er_offset) &&
+				((rd_offset - pg_offset >= SPI_FLASH_BLOCK_SIZE) || (rd_offset == length && pg_offset < rd_offset))) {
+				n = min(rd_offset - pg_offset, SPI_FLASH_BLOCK_SIZE);
+				if (sync) {
+					spiflash_mmap_sync();
+					sync = 0;
+				}
+				if (memcmp((void *)(SPIFLASH_BASE + pg_offset), ring + (pg_offset % ring_size), n) != 0) {
+					spiflash_page_program_start(pg_offset, ring + (pg_offset % ring_size), n);
+					nprogrammed++;
+				}
+				pg_offset += n;
+			/* Erase ahead the sectors that need it. */
+			} else if (er_offset < end) {
+				n = SPI_FLASH_SECTOR_SIZE;
+				if (flash_from_sdcard_needs_erase(er_offset)) {
+					n = flash_from_sdcard_erase_size(er_offset, end);
+					spiflash_erase_block_start(er_offset, n);
+					nerased += n/SPI_FLASH_SECTOR_SIZE;
+					sync = 1;
+				}
+				er_offset += n;
+			}
+		}
+
+		/* SDCard: fill the next free slot. */
+		if ((rd_offset < length) && (rd_offset - vf_offset + slot_size <= ring_size)) {
+			fr = f_read(file, ring + (rd_offset % ring_size), slot_size, (UINT *)&br);
+			if ((fr != FR_OK) || (br == 0)) {
+				printf("\nfile read error.\n");
+				break;
+			}
+			rd_offset += br;
+		}
+	}
+	printf("\n");
+	printf("SPI Flash: %d sectors erased, %d pages programmed.\n", nerased, nprogrammed);
+}
 
 static void flash_from_sdcard_handler(int nb_params, char **params)
 {
 	FRESULT fr;
 	FATFS fs;
 	FIL file;
-	uint32_t br;
-	uint32_t offset;
 	unsigned long length;
-	uint8_t buf[512];
+	char *c;
+#ifdef FLASH_FROM_SDCARD_RING_ADDR
+	uint8_t *ring = (uint8_t *)FLASH_FROM_SDCARD_RING_ADDR;
+	uint32_t slot_size = FLASH_FROM_SDCARD_EXT_SLOT_SIZE;
+	uint32_t ring_size = FLASH_FROM_SDCARD_EXT_RING_SIZE;
+#else
+	uint8_t ring_buf[FLASH_FROM_SDCARD_SLOTS*FLASH_FROM_SDCARD_SLOT_SIZE];
+	uint8_t *ring = ring_buf;
+	uint32_t slot_size = FLASH_FROM_SDCARD_SLOT_SIZE;
+	uint32_t ring_size = sizeof(ring_buf);
+#endif
 
 	if (nb_params < 1) {
-		printf("flash_from_sdcard <filename>");
+		printf("flash_from_sdcard <filename> [ring_addr (64KB, clobbered)]");
 		return;
 	}
 
 	char* filename = params[0];
 
+	if (nb_params > 1) {
+		ring = (uint8_t *)strtoul(params[1], &c, 0);
+		if (*c != 0) {
+			printf("Incorrect ring_addr");
+			return;
+		}
+		slot_size = FLASH_FROM_SDCARD_EXT_SLOT_SIZE;
+		ring_size = FLASH_FROM_SDCARD_EXT_RING_SIZE;
+	}
+
+#ifdef CSR_SPISDCARD_BASE
+	fatfs_set_ops_spisdcard();
+#endif
+#ifdef CSR_SDCARD_CORE_BASE
+	fatfs_set_ops_sdcard();
+#endif
 	fr = f_mount(&fs, "", 1);
 	if (fr != FR_OK)
 		return;
@@ -86,33 +289,20 @@ static void flash_from_sdcard_handler(int nb_params, char **params)
 	}
 
 	length = f_size(&file);
-	printf("Copying %s to SPI flash (%ld bytes)...\n", filename, length);
-	init_progression_bar(length);
-	offset = 0;
-	for (;;) {
-		fr = f_read(&file, (void*) buf, 512, (UINT *)&br);
-		if (fr != FR_OK) {
-			printf("file read error.\n");
-			f_close(&file);
-			f_mount(0, "", 0);
-			return;
-		}
-		if (br == 0) {
-			break;
-		} else {
-			spiflash_write_stream(offset, buf, br);
-		}
-
-		offset += br;
-		show_progress(offset);
+	if (length > FLASH_FROM_SDCARD_SECTORS*SPI_FLASH_SECTOR_SIZE)
+		printf("%s too large for the SPI flash.\n", filename);
+	else if (flash_from_sdcard_compare(&file, length, ring, slot_size) != 0)
+		printf("file read error.\n");
+	else {
+		printf("Copying %s to SPI flash (%ld bytes)...\n", filename, length);
+		flash_from_sdcard_copy(&file, length, ring, slot_size, ring_size);
 	}
-	show_progress(offset);
-	printf("\n");
 
 	f_close(&file);
 	f_mount(0, "", 0);
 }
 define_command(flash_from_sdcard, flash_from_sdcard_handler, "Write file from SD card to flash", SPIFLASH_CMDS);
+#endif
 
 static void flash_erase_range_handler(int nb_params, char **params)
 {
@@ -25,6 +25,7 @@
 #include "readline.h"
 #include "helpers.h"
 #include "command.h"
+#include "sim_debug.h"
 
 #include <generated/csr.h>
 #include <generated/soc.h>
@@ -33,11 +34,13 @@
 
 #include <libbase/console.h>
 #include <libbase/crc.h>
+#include <libbase/init_task.h>
 #include <libbase/memtest.h>
 
 #include <libbase/spiflash.h>
 #include <libbase/uart.h>
 #include <libbase/i2c.h>
+#include <libbase/trace.h>
 
 #include <liblitedram/sdram.h>
 #include <liblitedram/utils.h>
@@ -47,9 +50,49 @@
 
 #include <liblitespi/spiflash.h>
 
+#include <liblitesdcard/spisdcard.h>
 #include <liblitesdcard/sdcard.h>
 #include <liblitesata/sata.h>
 
+/* Record the start of a boot phase (also as a marker in simulation). */
+static void boot_phase(const char *name)
+{
+	trace_point(name);
+#ifdef CSR_SIM_MARKER_BASE
+	sim_mark(name);
+#endif
+}
+
+/* Device inits running in the background (init tasks) while DRAM is initialized/tested. */
+#ifdef CSR_ETHMAC_BASE
+static struct init_task eth_task = INIT_TASK("eth", eth_init_step);
+#endif
+#ifndef CONFIG_BIOS_NO_BOOT
+#if defined(CSR_SPISDCARD_BASE)
+static struct init_task sdcard_task = INIT_TASK("spisdcard", spisdcard_init_step);
+#elif defined(CSR_SDCARD_CORE_BASE)
+static struct init_task sdcard_task = INIT_TASK("sdcard", sdcard_init_step);
+#endif
+#if defined(CSR_SATA_SECTOR2MEM_BASE)
+static struct init_task sata_task = INIT_TASK("sata", sata_init_step);
+#endif
+#endif
+
+static void init_tasks_start(void)
+{
+#ifdef CSR_ETHMAC_BASE
+	init_task_start(&eth_task);
+#endif
+#ifndef CONFIG_BIOS_NO_BOOT
+#if defined(CSR_SPISDCARD_BASE) || defined(CSR_SDCARD_CORE_BASE)
+	init_task_start(&sdcard_task);
+#endif
+#if defined(CSR_SATA_SECTOR2MEM_BASE)
+	init_task_start(&sata_task);
+#endif
+#endif
+}
+
 #ifndef CONFIG_BIOS_NO_BOOT
 static void boot_sequence(void)
 {
@@ -64,12 +107,15 @@ static void boot_sequence(void)
 	romboot();
 #endif
 #if defined(CSR_SPISDCARD_BASE) || defined(CSR_SDCARD_CORE_BASE)
-	sdcardboot();
+	if (init_task_wait(&sdcard_task))
+		sdcardboot();
 #endif
 #if defined(CSR_SATA_SECTOR2MEM_BASE)
-	sataboot();
+	if (init_task_wait(&sata_task))
+		sataboot();
 #endif
 #ifdef CSR_ETHMAC_BASE
+	init_task_wait(&eth_task);
 #ifdef CSR_ETHPHY_MODE_DETECTION_MODE_ADDR
 	eth_mode();
 #endif
@@ -90,6 +136,7 @@ __attribute__((__used__)) int main(int i, char **c)
 #endif
 	int sdr_ok;
 
+	boot_phase("start");
 #ifdef CONFIG_CPU_HAS_INTERRUPT
 	irq_setmask(0);
 	irq_setie(1);
@@ -103,6 +150,7 @@ __attribute__((__used__)) int main(int i, char **c)
 #endif
 
 #ifndef CONFIG_BIOS_NO_PROMPT
+	boot_phase("banner");
 	printf("\n");
 	printf("\e[1m        __   _ __      _  __\e[0m\n");
 	printf("\e[1m       / /  (_) /____ | |/_/\e[0m\n");
@@ -259,10 +307,14 @@ __attribute__((__used__)) int main(int i, char **c)
 
 #if defined(CSR_ETHMAC_BASE) || defined(MAIN_RAM_BASE) || defined(CSR_SPIFLASH_CORE_BASE)
     printf("--========== \e[1mInitialization\e[0m ============--\n");
-#ifdef CSR_ETHMAC_BASE
-	eth_init();
 #endif
 
+	/* Start device inits, they progress while DRAM is initialized/tested */
+	boot_phase("init_tasks");
+	init_tasks_start();
+
+#if defined(CSR_ETHMAC_BASE) || defined(MAIN_RAM_BASE) || defined(CSR_SPIFLASH_CORE_BASE)
+
 	/* Initialize and test DRAM */
 #ifdef CSR_SDRAM_BASE
 	sdr_ok = sdram_init();
@@ -270,6 +322,7 @@ __attribute__((__used__)) int main(int i, char **c)
 	/* Test Main RAM when present and not pre-initialized */
 #ifdef MAIN_RAM_BASE
 #ifndef CONFIG_MAIN_RAM_INIT
+	boot_phase("main_ram_memtest");
 	sdr_ok = memtest((unsigned int *) MAIN_RAM_BASE, min(MAIN_RAM_SIZE, MEMTEST_DATA_SIZE));
 	memspeed((unsigned int *) MAIN_RAM_BASE, min(MAIN_RAM_SIZE, MEMTEST_DATA_SIZE), false, 0);
 #endif
@@ -278,10 +331,12 @@ __attribute__((__used__)) int main(int i, char **c)
 	if (sdr_ok != 1)
 		printf("Memory initialization failed\n");
 #endif
+	init_tasks_poll();
 
 	/* Initialize and test SPIFLASH */
 #ifdef CSR_SPIFLASH_CORE_BASE
 	spiflash_init();
+	init_tasks_poll();
 #endif
 	printf("\n");
 
@@ -295,18 +350,25 @@ __attribute__((__used__)) int main(int i, char **c)
 #endif
 
 	/* Execute  initialization functions */
+	boot_phase("init_dispatcher");
 	init_dispatcher();
 
+	/* Boot time breakdown */
+	trace_summary();
+
 	/* Execute Boot sequence */
 #ifndef CONFIG_BIOS_NO_BOOT
 	if(sdr_ok) {
 		printf("--============== \e[1mBoot\e[0m ==================--\n");
+		boot_phase("boot_sequence");
 		boot_sequence();
 		printf("\n");
 	}
 #endif
 
 	/* Console */
+	boot_phase("console");
+	init_tasks_wait_all();
 #ifdef BIOS_CONSOLE_DISABLE
 	printf("--======= \e[1mDone (No Console) \e[0m ==========--\n");
 #else
@@ -19,6 +19,7 @@ struct sfl_frame {
 #define SFL_CMD_ABORT		0x00
 #define SFL_CMD_LOAD		0x01
 #define SFL_CMD_JUMP		0x02
+#define SFL_CMD_BAUDRATE	0x03 /* Payload: baudrate (32-bit, big endian), optional test data */
 
 /* Replies */
 #define SFL_ACK_SUCCESS		'K'
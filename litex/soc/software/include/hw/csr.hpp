@@ -0,0 +1,149 @@
+#ifndef __HW_CSR_HPP
+#define __HW_CSR_HPP
+
+/* Compile-time specialized CSR accessors for C++ firmware (C++11).
+ *
+ * Address, size and subregister layout of each CSR are template parameters, so each access
+ * compiles to the minimal straight-line sequence of csr_[read|write]_simple() (no loop over
+ * num_subregs(), even at -Os). The registers of the SoC are declared in generated/csr.hpp:
+ *
+ *   #include <generated/csr.hpp>
+ *
+ *   uint32_t v = litex::csr::timer0::value::read();
+ *   litex::csr::leds::out::write(0x5);
+ *
+ *   // Fields are merged into a single register write:
+ *   using namespace litex::csr::ctrl;
+ *   reset::write(reset_fields::soc_rst::encode(0) | reset_fields::cpu_rst::encode(1));
+ */
+
+#include <stdint.h>
+
+#include <generated/csr.h>
+
+namespace litex {
+
+/* Subregisters I..N-1 of a CSR (most significant subregister at the lowest address). */
+template <unsigned long Addr, typename T, unsigned Busword, unsigned Stride, unsigned I, unsigned N>
+struct csr_subregs {
+	static inline __attribute__((always_inline)) T read(T r) {
+		return csr_subregs<Addr, T, Busword, Stride, I + 1, N>::read(
+			(T)((r << Busword) | csr_read_simple(Addr + I*Stride)));
+	}
+	static inline __attribute__((always_inline)) void write(T v) {
+		csr_write_simple((unsigned long)(v >> (Busword*(N - 1 - I))), Addr + I*Stride);
+		csr_subregs<Addr, T, Busword, Stride, I + 1, N>::write(v);
+	}
+};
+
+template <unsigned long Addr, typename T, unsigned Busword, unsigned Stride, unsigned N>
+struct csr_subregs<Addr, T, Busword, Stride, N, N> {
+	static inline __attribute__((always_inline)) T read(T r) { return r; }
+	static inline __attribute__((always_inline)) void write(T) {}
+};
+
+/* CSR of NWords subregisters of Busword bits, accessed as T. */
+template <unsigned long Addr, typename T, unsigned NWords, unsigned Busword, unsigned Stride, bool ReadOnly>
+struct csr_reg {
+	typedef T type;
+	static constexpr unsigned long addr = Addr;
+	static constexpr unsigned nwords    = NWords;
+
+	static inline __attribute__((always_inline)) T read(void) {
+		return csr_subregs<Addr, T, Busword, Stride, 1, NWords>::read((T)csr_read_simple(Addr));
+	}
+	static inline __attribute__((always_inline)) void write(T v) {
+		static_assert(!ReadOnly, "CSR is read-only");
+		csr_subregs<Addr, T, Busword, Stride, 0, NWords>::write(v);
+	}
+	/* Read-modify-write of the bits of mask. */
+	static inline __attribute__((always_inline)) void modify(T mask, T v) {
+		write((read() & ~mask) | (v & mask));
+	}
+};
+
+/* Field of Size bits at Offset of register Reg. */
+template <typename Reg, unsigned Offset, unsigned Size>
+struct csr_field {
+	typedef typename Reg::type type;
+	static constexpr unsigned offset = Offset;
+	static constexpr unsigned size   = Size;
+	static constexpr type     mask   = (type)(((Size < 8*sizeof(type)) ? ((type)1 << Size) : 0) - 1) << Offset;
+
+	/* Value of the field in the register (to OR with other fields for a single write). */
+	static constexpr type encode(type v) {
+		return (type)(v << Offset) & mask;
+	}
+	static constexpr type extract(type word) {
+		return (type)(word & mask) >> Offset;
+	}
+	static inline __attribute__((always_inline)) type read(void) {
+		return extract(Reg::read());
+	}
+	static inline __attribute__((always_inline)) void write(type v) {
+		Reg::modify(mask, encode(v));
+	}
+};
+
+/* Byte-array view of a CSR larger than 64-bit (same layout as csr_[rd|wr]_buf_uint8()):
+ * Bytes bytes stored in NWords subregisters of Busword bits, first byte most significant. */
+template <unsigned long Addr, unsigned Bytes, unsigned NWords, unsigned Busword, unsigned Stride, unsigned I, unsigned J>
+struct csr_bytes_subreg {
+	static constexpr unsigned nsubelems = Busword/8;
+	static constexpr int      index     = (int)(I*nsubelems + J) - (int)(NWords*nsubelems - Bytes);
+
+	/* Byte J (J = nsubelems-1 is the least significant) of subregister I. */
+	static inline __attribute__((always_inline)) void read(uint8_t *buf, unsigned long r) {
+		if (index >= 0)
+			buf[index] = r;
+		csr_bytes_subreg<Addr, Bytes, NWords, Busword, Stride, I, J - 1>::read(buf, r >> 8);
+	}
+	static inline __attribute__((always_inline)) unsigned long value(const uint8_t *buf) {
+		return (csr_bytes_subreg<Addr, Bytes, NWords, Busword, Stride, I, J - 1>::value(buf) << 8) |
+			((index >= 0) ? buf[index] : 0);
+	}
+};
+
+template <unsigned long Addr, unsigned Bytes, unsigned NWords, unsigned Busword, unsigned Stride, unsigned I>
+struct csr_bytes_subreg<Addr, Bytes, NWords, Busword, Stride, I, (unsigned)-1> {
+	static inline __attribute__((always_inline)) void read(uint8_t *, unsigned long) {}
+	static inline __attribute__((always_inline)) unsigned long value(const uint8_t *) { return 0; }
+};
+
+template <unsigned long Addr, unsigned Bytes, unsigned NWords, unsigned Busword, unsigned Stride, unsigned I>
+struct csr_bytes_subregs {
+	typedef csr_bytes_subreg<Addr, Bytes, NWords, Busword, Stride, I, Busword/8 - 1> subreg;
+
+	static inline __attribute__((always_inline)) void read(uint8_t *buf) {
+		subreg::read(buf, csr_read_simple(Addr + I*Stride));
+		csr_bytes_subregs<Addr, Bytes, NWords, Busword, Stride, I + 1>::read(buf);
+	}
+	static inline __attribute__((always_inline)) void write(const uint8_t *buf) {
+		csr_write_simple(subreg::value(buf), Addr + I*Stride);
+		csr_bytes_subregs<Addr, Bytes, NWords, Busword, Stride, I + 1>::write(buf);
+	}
+};
+
+template <unsigned long Addr, unsigned Bytes, unsigned NWords, unsigned Busword, unsigned Stride>
+struct csr_bytes_subregs<Addr, Bytes, NWords, Busword, Stride, NWords> {
+	static inline __attribute__((always_inline)) void read(uint8_t *) {}
+	static inline __attribute__((always_inline)) void write(const uint8_t *) {}
+};
+
+template <unsigned long Addr, unsigned Bytes, unsigned NWords, unsigned Busword, unsigned Stride, bool ReadOnly>
+struct csr_bytes {
+	static constexpr unsigned long addr = Addr;
+	static constexpr unsigned size      = Bytes;
+
+	static inline __attribute__((always_inline)) void read(uint8_t *buf) {
+		csr_bytes_subregs<Addr, Bytes, NWords, Busword, Stride, 0>::read(buf);
+	}
+	static inline __attribute__((always_inline)) void write(const uint8_t *buf) {
+		static_assert(!ReadOnly, "CSR is read-only");
+		csr_bytes_subregs<Addr, Bytes, NWords, Busword, Stride, 0>::write(buf);
+	}
+};
+
+} /* namespace litex */
+
+#endif /* __HW_CSR_HPP */
@@ -1,3 +1,5 @@
+#include <stdio.h>
+
 #include <libbase/console.h>
 #include <libbase/uart.h>
 
@@ -6,6 +8,8 @@
 int readchar_nonblock(void)
 {
 #ifdef CSR_UART_BASE
+	/* Make buffered output visible while polling for input */
+	fflush(stdout);
 	return uart_read_nonblock();
 #else
 	return 1;
@@ -3,8 +3,20 @@
  * For conditions of distribution and use, see copyright notice in zlib.h
  */
 
+#include <stdint.h>
+
+#include <system.h>
+#include <generated/csr.h>
+
 #include "crc.h"
 
+/* With the CRC32 accelerator (add_crc), the word-aligned part of buffers of at least
+ * CRC32_HW_MIN_SIZE bytes is processed by the hardware (read by its DMA when present, written
+ * word by word by the CPU otherwise), the unaligned head/tail in software. */
+#ifndef CRC32_HW_MIN_SIZE
+#define CRC32_HW_MIN_SIZE 64
+#endif
+
 #ifndef SMALL_CRC
 static const unsigned int crc_table[256] = {
 	0x00000000L, 0x77073096L, 0xee0e612cL, 0x990951baL, 0x076dc419L,
@@ -66,11 +78,8 @@ static const unsigned int crc_table[256] = {
 #define DO4(buf)  DO2(buf); DO2(buf);
 #define DO8(buf)  DO4(buf); DO4(buf);
 
-unsigned int crc32(const unsigned char *buffer, unsigned int len)
+static unsigned int crc32_update(unsigned int crc, const unsigned char *buffer, unsigned int len)
 {
-	unsigned int crc;
-	crc = 0;
-	crc = crc ^ 0xffffffffL;
 	while(len >= 8) {
 		DO8(buffer);
 		len -= 8;
@@ -78,15 +87,14 @@ unsigned int crc32(const unsigned char *buffer, unsigned int len)
 	if(len) do {
 		DO1(buffer);
 	} while(--len);
-	return crc ^ 0xffffffffL;
+	return crc;
 }
 #else
-unsigned int crc32(const unsigned char *message, unsigned int len) {
+static unsigned int crc32_update(unsigned int crc, const unsigned char *message, unsigned int len) {
    int i, j;
-   unsigned int byte, crc, mask;
+   unsigned int byte, mask;
 
    i = 0;
-   crc = 0xFFFFFFFF;
    while (i < len) {
       byte = message[i];            // Get next byte.
       crc = crc ^ byte;
@@ -96,6 +104,49 @@ unsigned int crc32(const unsigned char *message, unsigned int len) {
       }
       i = i + 1;
    }
-   return ~crc;
+   return crc;
+}
+#endif
+
+#ifdef CSR_CRC_BASE
+static unsigned int crc32_hw_update(unsigned int crc, const unsigned char *buffer, unsigned int len)
+{
+	crc_init_write(crc);
+#ifdef CSR_CRC_DMA_ENABLE_ADDR
+	/* Write back the CPU data cache (when write-back) before the DMA reads memory. */
+	flush_cpu_dcache();
+	crc_dma_base_write((uintptr_t) buffer);
+	crc_dma_length_write(len);
+	crc_dma_enable_write(1);
+	while (!crc_dma_done_read());
+	crc_dma_enable_write(0);
+#else
+	{
+		const uint32_t *words = (const uint32_t *) buffer;
+		unsigned int i;
+		for(i=0;i<len/4;i++)
+			crc_data_write(words[i]);
+	}
+#endif
+	return crc_value_read();
 }
 #endif
+
+unsigned int crc32(const unsigned char *buffer, unsigned int len)
+{
+	unsigned int crc;
+	crc = 0xffffffffL;
+#ifdef CSR_CRC_BASE
+	if(len >= CRC32_HW_MIN_SIZE) {
+		unsigned int head, words;
+		head  = -(uintptr_t) buffer & 3;
+		crc   = crc32_update(crc, buffer, head);
+		words = (len - head) & ~3;
+		crc   = crc32_hw_update(crc, buffer + head, words);
+		buffer += head + words;
+		len    -= head + words;
+	}
+#endif
+	crc = crc32_update(crc, buffer, len);
+	return crc ^ 0xffffffffL;
+}
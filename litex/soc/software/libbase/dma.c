@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#include <stdint.h>
+#include <string.h>
+
+#include <system.h>
+
+#include <libbase/dma.h>
+
+#ifdef DMA_AVAILABLE
+
+static int dma_aligned(uintptr_t x)
+{
+	return (x & (DMA_WORD_BYTES - 1)) == 0;
+}
+
+static void dma_start(void *dst, size_t n, int fill)
+{
+	/* Write back the CPU data cache (when write-back) before the engine reads memory. */
+	flush_cpu_dcache();
+	dma_copy_dst_write((uintptr_t) dst);
+	dma_copy_length_write(n);
+	dma_copy_control_write(
+		(fill ? 1 : 0) << CSR_DMA_COPY_CONTROL_FILL_OFFSET |
+		1              << CSR_DMA_COPY_CONTROL_START_OFFSET);
+}
+
+int dma_memcpy_start(void *dst, const void *src, size_t n)
+{
+	if ((n == 0) || !dma_aligned((uintptr_t) dst | (uintptr_t) src | n) || !dma_done())
+		return 0;
+	dma_copy_src_write((uintptr_t) src);
+	dma_start(dst, n, 0);
+	return 1;
+}
+
+int dma_memset_start(void *dst, int c, size_t n)
+{
+	return dma_fill_start(dst, 0x01010101u*(uint8_t) c, n);
+}
+
+int dma_fill_start(void *dst, uint32_t value, size_t n)
+{
+	if ((n == 0) || !dma_aligned((uintptr_t) dst | n) || !dma_done())
+		return 0;
+	dma_copy_value_write(value);
+	dma_start(dst, n, 1);
+	return 1;
+}
+
+int dma_done(void)
+{
+	return (dma_copy_status_read() >> CSR_DMA_COPY_STATUS_DONE_OFFSET) & 1;
+}
+
+size_t dma_progress(void)
+{
+	return dma_done() ? 0 : dma_copy_offset_read();
+}
+
+void dma_wait(void)
+{
+	while (!dma_done());
+	/* Drop stale destination lines from the CPU data cache. */
+	flush_cpu_dcache();
+}
+
+/* Split [dst, dst + n) in a CPU head, an engine-aligned middle and a CPU tail. */
+static size_t dma_split(uintptr_t dst, size_t n, size_t *head)
+{
+	*head = (DMA_WORD_BYTES - (dst & (DMA_WORD_BYTES - 1))) & (DMA_WORD_BYTES - 1);
+	if ((n < DMA_MIN_SIZE) || (n < *head))
+		return 0;
+	return (n - *head) & ~(size_t) (DMA_WORD_BYTES - 1);
+}
+
+void *dma_memcpy(void *dst, const void *src, size_t n)
+{
+	size_t head, middle;
+
+	middle = dma_split((uintptr_t) dst, n, &head);
+	if ((middle == 0) || !dma_aligned((uintptr_t) src + head) ||
+		!dma_memcpy_start((char *) dst + head, (const char *) src + head, middle))
+		return memcpy(dst, src, n);
+	memcpy(dst, src, head);
+	memcpy((char *) dst + head + middle, (const char *) src + head + middle, n - head - middle);
+	dma_wait();
+	return dst;
+}
+
+void *dma_memset(void *dst, int c, size_t n)
+{
+	size_t head, middle;
+
+	middle = dma_split((uintptr_t) dst, n, &head);
+	if ((middle == 0) || !dma_memset_start((char *) dst + head, c, middle))
+		return memset(dst, c, n);
+	memset(dst, c, head);
+	memset((char *) dst + head + middle, c, n - head - middle);
+	dma_wait();
+	return dst;
+}
+
+#else
+
+int dma_memcpy_start(void *dst, const void *src, size_t n)
+{
+	return 0;
+}
+
+int dma_memset_start(void *dst, int c, size_t n)
+{
+	return 0;
+}
+
+int dma_fill_start(void *dst, uint32_t value, size_t n)
+{
+	return 0;
+}
+
+int dma_done(void)
+{
+	return 1;
+}
+
+size_t dma_progress(void)
+{
+	return 0;
+}
+
+void dma_wait(void)
+{
+}
+
+void *dma_memcpy(void *dst, const void *src, size_t n)
+{
+	return memcpy(dst, src, n);
+}
+
+void *dma_memset(void *dst, int c, size_t n)
+{
+	return memset(dst, c, n);
+}
+
+#endif
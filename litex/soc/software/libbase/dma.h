@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#ifndef __DMA_H
+#define __DMA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <generated/csr.h>
+#include <generated/soc.h>
+
+/* Memory copy/fill with the DMA Copy engine of the SoC (add_dma_copy), CPU otherwise.
+ *
+ * Asynchronous API: dma_memcpy_start()/dma_memset_start()/dma_fill_start() (32-bit pattern)
+ * start a transfer and return 1, or 0
+ * when nothing has been started (no engine, engine busy, transfer not aligned on the bus data
+ * width) and the caller has to do the copy itself. dma_done() polls the completion,
+ * dma_progress() returns the bytes already written and dma_wait() waits for the completion
+ * (and must be called before the CPU accesses the destination).
+ *
+ * Synchronous API: dma_memcpy()/dma_memset() have the memcpy()/memset() semantics, the engine
+ * handles the aligned part of large transfers, the CPU the rest.
+ */
+
+#ifdef CSR_DMA_COPY_BASE
+#define DMA_AVAILABLE
+#define DMA_WORD_BYTES (CONFIG_BUS_DATA_WIDTH/8)
+#endif
+
+/* Minimum size of a synchronous transfer done with the engine (CPU is faster below). */
+#ifndef DMA_MIN_SIZE
+#define DMA_MIN_SIZE 256
+#endif
+
+int dma_memcpy_start(void *dst, const void *src, size_t n);
+int dma_memset_start(void *dst, int c, size_t n);
+int dma_fill_start(void *dst, uint32_t value, size_t n);
+int dma_done(void);
+size_t dma_progress(void);
+void dma_wait(void);
+
+void *dma_memcpy(void *dst, const void *src, size_t n);
+void *dma_memset(void *dst, int c, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DMA_H */
@@ -8,21 +8,45 @@
 #include <generated/csr.h>
 
 #include <system.h>
+#include <hw/common.h>
+
+#include "timebase.h"
 
 #ifdef CONFIG_HAS_I2C
 #include <generated/i2c.h>
 
-#define U_SECOND	(1000000)
-#define I2C_PERIOD	(U_SECOND / I2C_FREQ_HZ)
-#define I2C_DELAY(n)	busy_wait_us(n * I2C_PERIOD / 4)
+/* Hardware controller command/status bits (see I2CMaster.add_controller) */
+#define I2C_CTRL_START  (1 << 8)
+#define I2C_CTRL_WRITE  (1 << 9)
+#define I2C_CTRL_READ   (1 << 10)
+#define I2C_CTRL_ACK    (1 << 11)
+#define I2C_CTRL_STOP   (1 << 12)
+#define I2C_CTRL_BUSY   (1 << 8)
+#define I2C_CTRL_NACK   (1 << 9)
 
 int current_i2c_dev = DEFAULT_I2C_DEV;
 
+static unsigned int i2c_freq_hz = I2C_FREQ_HZ;
+static int          i2c_timing_dev = -1;  /* Device the timing below was set up for */
+static uint32_t     i2c_quarter_ticks;    /* Bit-banging quarter SCL period (0: as fast as possible) */
+static uint64_t     i2c_edge;             /* Bit-banging time of the last line update */
+static unsigned int i2c_ctrl_pending;     /* Controller START to issue with the next byte */
+
 struct i2c_dev *get_i2c_devs(void) { return i2c_devs; }
 int get_i2c_devs_count(void)       { return I2C_DEVS_COUNT; }
 void set_i2c_active_dev(int dev)   { current_i2c_dev = dev; }
 int get_i2c_active_dev(void)       { return current_i2c_dev; }
 
+void i2c_set_freq(unsigned int freq_hz)
+{
+	if (freq_hz == 0)
+		return;
+	i2c_freq_hz    = freq_hz;
+	i2c_timing_dev = -1;
+}
+
+unsigned int i2c_get_freq(void) { return i2c_freq_hz; }
+
 int i2c_send_init_cmds(void)
 {
 #ifdef I2C_INIT
@@ -60,20 +84,108 @@ int i2c_send_init_cmds(void)
 	return 0;
 }
 
+static inline const struct i2c_ctrl *i2c_ctrl(void)
+{
+	const struct i2c_ctrl *ctrl = &i2c_devs[current_i2c_dev].ctrl;
+
+	return ctrl->cmd_addr ? ctrl : NULL;
+}
+
 static inline void i2c_oe_scl_sda(bool oe, bool scl, bool sda)
 {
-	struct i2c_ops ops = i2c_devs[current_i2c_dev].ops;
+	const struct i2c_ops *ops = &i2c_devs[current_i2c_dev].ops;
 
-	ops.write(
-		((oe & 1)  << ops.w_oe_offset)	|
-		((scl & 1) << ops.w_scl_offset) |
-		((sda & 1) << ops.w_sda_offset)
+	ops->write(
+		((oe & 1)  << ops->w_oe_offset)	|
+		((scl & 1) << ops->w_scl_offset) |
+		((sda & 1) << ops->w_sda_offset)
 	);
 }
 
+/*
+ * Derive the SCL timing of the active device from CONFIG_CLOCK_FREQUENCY: quarter period
+ * divider of the hardware controller, or bit-banging quarter period. Bit-banging delays are
+ * measured from the previous line update (so the CSR write and timebase costs are absorbed),
+ * and skipped entirely when a line update already takes longer than a quarter period.
+ */
+static void i2c_timing(void)
+{
+	const struct i2c_ctrl *ctrl = i2c_ctrl();
+	uint32_t quarter;
+	uint64_t t;
+	int i;
+
+	if (i2c_timing_dev == current_i2c_dev)
+		return;
+	i2c_timing_dev = current_i2c_dev;
+
+	quarter = (CONFIG_CLOCK_FREQUENCY + 4*i2c_freq_hz - 1)/(4*i2c_freq_hz);
+	i2c_quarter_ticks = quarter;
+	if (ctrl) {
+		csr_wr_uint16(min(max(quarter, 1) - 1, 0xffff), ctrl->clkdiv_addr);
+		return;
+	}
+
+	t = timebase_now();
+	for (i = 0; i < 4; i++) {
+		i2c_oe_scl_sda(1, 1, 1);
+		timebase_now();
+	}
+	if ((timebase_now() - t)/4 >= quarter)
+		i2c_quarter_ticks = 0;
+}
+
+static void i2c_delay(int n)
+{
+	uint64_t now;
+
+	if (i2c_quarter_ticks == 0)
+		return;
+	i2c_edge += n*i2c_quarter_ticks;
+	now = timebase_now();
+	if (now >= i2c_edge) {
+		/* Late (first edge or slow line update): restart from now */
+		i2c_edge = now;
+		return;
+	}
+	while (timebase_now() < i2c_edge);
+}
+
+#define I2C_DELAY(n)	i2c_delay(n)
+
+/* A controller command lasts at most START + 9 bits + STOP = 44 quarter SCL periods */
+#define I2C_CTRL_TIMEOUT_QUARTERS	(2*44)
+#define I2C_CTRL_TIMEOUT_MIN_US		100
+
+/* Issue a hardware controller command and wait for its completion, return the status or -1 if
+   the controller is still busy after twice the command duration */
+static int i2c_ctrl_cmd(const struct i2c_ctrl *ctrl, unsigned int cmd)
+{
+	unsigned int status;
+	uint64_t deadline;
+
+	deadline = timebase_deadline_us(I2C_CTRL_TIMEOUT_MIN_US) +
+		(uint64_t) I2C_CTRL_TIMEOUT_QUARTERS*i2c_quarter_ticks;
+	csr_wr_uint16(cmd | i2c_ctrl_pending, ctrl->cmd_addr);
+	i2c_ctrl_pending = 0;
+	do {
+		status = csr_rd_uint16(ctrl->status_addr);
+		if (!(status & I2C_CTRL_BUSY))
+			return status;
+	} while (!timebase_expired(deadline));
+
+	return -1;
+}
+
 // START condition: 1-to-0 transition of SDA when SCL is 1
 static void i2c_start(void)
 {
+	i2c_timing();
+	if (i2c_ctrl()) {
+		/* Merged with the next (address) byte */
+		i2c_ctrl_pending = I2C_CTRL_START;
+		return;
+	}
 	i2c_oe_scl_sda(1, 1, 1);
 	I2C_DELAY(1);
 	i2c_oe_scl_sda(1, 1, 0);
@@ -83,7 +195,7 @@ static void i2c_start(void)
 }
 
 // STOP condition: 0-to-1 transition of SDA when SCL is 1
-static void i2c_stop(void)
+static void i2c_bitbang_stop(void)
 {
 	i2c_oe_scl_sda(1, 0, 0);
 	I2C_DELAY(1);
@@ -94,6 +206,16 @@ static void i2c_stop(void)
 	i2c_oe_scl_sda(0, 1, 1);
 }
 
+static void i2c_stop(void)
+{
+	const struct i2c_ctrl *ctrl = i2c_ctrl();
+
+	if (ctrl)
+		i2c_ctrl_cmd(ctrl, I2C_CTRL_STOP);
+	else
+		i2c_bitbang_stop();
+}
+
 // Call when in the middle of SCL low, advances one clk period
 static void i2c_transmit_bit(int value)
 {
@@ -121,11 +243,18 @@ static int i2c_receive_bit(void)
 	return value;
 }
 
-// Send data byte and return 1 if slave sends ACK
+// Send data byte and return 1 if slave sends ACK (0 on NACK or controller timeout)
 static bool i2c_transmit_byte(unsigned char data)
 {
+	const struct i2c_ctrl *ctrl = i2c_ctrl();
 	int i;
 	int ack;
+	int status;
+
+	if (ctrl) {
+		status = i2c_ctrl_cmd(ctrl, I2C_CTRL_WRITE | data);
+		return (status >= 0) && !(status & I2C_CTRL_NACK);
+	}
 
 	// SCL should have already been low for 1/4 cycle
 	// Keep SDA low to avoid short spikes from the pull-ups
@@ -142,12 +271,19 @@ static bool i2c_transmit_byte(unsigned char data)
 	return ack == 0;
 }
 
-// Read data byte and send ACK if ack=1
-static unsigned char i2c_receive_byte(bool ack)
+// Read data byte and send ACK if ack=1, return -1 on controller timeout
+static int i2c_receive_byte(bool ack)
 {
+	const struct i2c_ctrl *ctrl = i2c_ctrl();
 	int i;
+	int status;
 	unsigned char data = 0;
 
+	if (ctrl) {
+		status = i2c_ctrl_cmd(ctrl, I2C_CTRL_READ | (ack ? I2C_CTRL_ACK : 0));
+		return (status < 0) ? -1 : (status & 0xff);
+	}
+
 	for (i = 0; i < 8; ++i) {
 		data <<= 1;
 		data |= i2c_receive_bit();
@@ -158,10 +294,12 @@ static unsigned char i2c_receive_byte(bool ack)
 	return data;
 }
 
-// Reset line state
+// Reset line state (always bit-banged, the hardware controller regains the lines on its next command)
 void i2c_reset(void)
 {
 	int i;
+	i2c_timing();
+	i2c_ctrl_pending = 0;
 	i2c_oe_scl_sda(1, 1, 1);
 	I2C_DELAY(8);
 	for (i = 0; i < 9; ++i) {
@@ -172,7 +310,7 @@ void i2c_reset(void)
 	}
 	i2c_oe_scl_sda(0, 0, 1);
 	I2C_DELAY(1);
-	i2c_stop();
+	i2c_bitbang_stop();
 	i2c_oe_scl_sda(0, 1, 1);
 	I2C_DELAY(8);
 }
@@ -188,6 +326,7 @@ void i2c_reset(void)
 bool i2c_read(unsigned char slave_addr, unsigned int addr, unsigned char *data, unsigned int len, bool send_stop, unsigned int addr_size)
 {
 	int i, j;
+	int value;
 
 	if ((addr_size<1) || (addr_size>4)) {
 		return false;
@@ -216,7 +355,12 @@ bool i2c_read(unsigned char slave_addr, unsigned int addr, unsigned char *data,
 		return false;
 	}
 	for (i = 0; i < len; ++i) {
-		data[i] = i2c_receive_byte(i != len - 1);
+		value = i2c_receive_byte(i != len - 1);
+		if (value < 0) {
+			i2c_stop();
+			return false;
+		}
+		data[i] = value;
 	}
 
 	i2c_stop();
@@ -262,6 +406,51 @@ bool i2c_write(unsigned char slave_addr, unsigned int addr, const unsigned char
 	return true;
 }
 
+/*
+ * Write slave memory over I2C with page writes (EEPROMs): the data is split at page_size
+ * boundaries and the end of the internal write cycle of each page is detected with ACK polling
+ */
+bool i2c_write_pages(unsigned char slave_addr, unsigned int addr, const unsigned char *data, unsigned int len, unsigned int addr_size, unsigned int page_size)
+{
+	unsigned int chunk;
+
+	if (page_size == 0) {
+		return false;
+	}
+
+	while (len > 0) {
+		chunk = page_size - (addr % page_size);
+		if (chunk > len)
+			chunk = len;
+		if (!i2c_write(slave_addr, addr, data, chunk, addr_size))
+			return false;
+		if (!i2c_wait_ack(slave_addr, I2C_WRITE_CYCLE_TIMEOUT_US))
+			return false;
+		addr += chunk;
+		data += chunk;
+		len  -= chunk;
+	}
+
+	return true;
+}
+
+/*
+ * Wait for I2C slave at given address to ACK its address (end of an EEPROM write cycle)
+ */
+bool i2c_wait_ack(unsigned char slave_addr, unsigned int timeout_us)
+{
+	uint64_t deadline = timebase_deadline_us(timeout_us);
+	bool ack;
+
+	do {
+		i2c_start();
+		ack = i2c_transmit_byte(I2C_ADDR_WR(slave_addr));
+		i2c_stop();
+	} while (!ack && !timebase_expired(deadline));
+
+	return ack;
+}
+
 /*
  * Poll I2C slave at given address, return true if it sends an ACK back
  */
@@ -19,9 +19,18 @@ struct i2c_ops {
 	int w_oe_offset;
 };
 
+/* Byte-level hardware controller (I2CMaster with_controller=True), used instead of bit-banging
+ * when present (cmd_addr != 0). */
+struct i2c_ctrl {
+	unsigned long cmd_addr;
+	unsigned long status_addr;
+	unsigned long clkdiv_addr;
+};
+
 struct i2c_dev {
 	char *name;
 	struct i2c_ops ops;
+	struct i2c_ctrl ctrl;
 };
 
 /* I2C frequency defaults to a safe value in range 10-100 kHz to be compatible with SMBus */
@@ -29,13 +38,26 @@ struct i2c_dev {
 #define I2C_FREQ_HZ  50000
 #endif
 
+#define I2C_FREQ_STANDARD   100000
+#define I2C_FREQ_FAST       400000
+#define I2C_FREQ_FAST_PLUS 1000000
+
+/* Maximum duration of an EEPROM internal write cycle (ACK polling timeout of i2c_write_pages) */
+#ifndef I2C_WRITE_CYCLE_TIMEOUT_US
+#define I2C_WRITE_CYCLE_TIMEOUT_US 20000
+#endif
+
 #define I2C_ADDR_WR(addr) ((addr) << 1)
 #define I2C_ADDR_RD(addr) (((addr) << 1) | 1u)
 
 void i2c_reset(void);
 bool i2c_write(unsigned char slave_addr, unsigned int addr, const unsigned char *data, unsigned int len, unsigned int addr_size);
 bool i2c_read(unsigned char slave_addr, unsigned int addr, unsigned char *data, unsigned int len, bool send_stop, unsigned int addr_size);
+bool i2c_write_pages(unsigned char slave_addr, unsigned int addr, const unsigned char *data, unsigned int len, unsigned int addr_size, unsigned int page_size);
 bool i2c_poll(unsigned char slave_addr);
+bool i2c_wait_ack(unsigned char slave_addr, unsigned int timeout_us);
+void i2c_set_freq(unsigned int freq_hz);
+unsigned int i2c_get_freq(void);
 int i2c_send_init_cmds(void);
 struct i2c_dev *get_i2c_devs(void);
 int get_i2c_devs_count(void);
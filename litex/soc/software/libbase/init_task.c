@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#include <stdio.h>
+
+#include "init_task.h"
+#include "timebase.h"
+
+static struct init_task *init_tasks;
+
+static void init_task_step_once(struct init_task *task)
+{
+	if (task->step(task) == INIT_TASK_PENDING)
+		return;
+	task->done = 1;
+}
+
+static int init_task_unlink(struct init_task *task)
+{
+	struct init_task **t;
+
+	for (t = &init_tasks; *t; t = &(*t)->next) {
+		if (*t == task) {
+			*t = task->next;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* Register a task and run its first step. */
+void init_task_start(struct init_task *task)
+{
+	init_task_unlink(task);
+	task->state   = 0;
+	task->result  = 0;
+	task->done    = 0;
+	task->retries = 0;
+	task->wake    = 0;
+	task->next    = init_tasks;
+	init_tasks    = task;
+	init_task_step_once(task);
+}
+
+/* Called from a step function: do not call the step again before ms milliseconds. */
+void init_task_sleep(struct init_task *task, unsigned int ms)
+{
+	task->wake = timebase_deadline_us((uint64_t) ms*1000);
+}
+
+/* Run one step of each task whose deadline is reached; completed tasks are unlinked. */
+void init_tasks_poll(void)
+{
+	struct init_task **t;
+	struct init_task *task;
+	uint64_t now;
+
+	now = timebase_now();
+	t   = &init_tasks;
+	while ((task = *t) != NULL) {
+		if (!task->done && now >= task->wake) {
+			init_task_step_once(task);
+			now = timebase_now();
+		}
+		if (task->done)
+			*t = task->next;
+		else
+			t = &task->next;
+	}
+}
+
+/* Poll all tasks until the given one is done and return its result. */
+int init_task_wait(struct init_task *task)
+{
+	struct init_task **t;
+
+	/* Start the task if it was not */
+	for (t = &init_tasks; *t && *t != task; t = &(*t)->next);
+	if (!*t && !task->done)
+		init_task_start(task);
+
+	while (!task->done)
+		init_tasks_poll();
+	init_task_unlink(task);
+	return task->result;
+}
+
+/* Blocking init: start the task and wait for its completion. */
+int init_task_run(struct init_task *task)
+{
+	init_task_start(task);
+	return init_task_wait(task);
+}
+
+void init_tasks_wait_all(void)
+{
+	while (init_tasks)
+		init_tasks_poll();
+}
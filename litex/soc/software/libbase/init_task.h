@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#ifndef __INIT_TASK_H
+#define __INIT_TASK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* Cooperative init tasks: a device init is split into a step function (a small state machine
+ * driven by task->state) that never blocks; instead of busy waiting it calls init_task_sleep()
+ * and returns INIT_TASK_PENDING, and the scheduler calls it again once the deadline is reached.
+ * This lets device wait times (PHY resets, card power-up, link-up) overlap with other init work
+ * (DRAM calibration/memtest) that calls init_tasks_poll() between its phases. Deadlines use
+ * the timebase.
+ */
+
+#define INIT_TASK_DONE    0
+#define INIT_TASK_PENDING 1
+
+struct init_task;
+typedef int (*init_task_step)(struct init_task *task);
+
+struct init_task {
+	const char      *name;
+	init_task_step   step;
+	int              state;  /* Step function's state, 0 on start.              */
+	int              result; /* Step function's result, valid once done.        */
+	int              done;
+	int              retries;
+	uint64_t         wake;   /* Timebase ticks before which step is not called. */
+	struct init_task *next;
+};
+
+#define INIT_TASK(_name, _step) { .name = _name, .step = _step }
+
+void init_task_start(struct init_task *task);
+void init_task_sleep(struct init_task *task, unsigned int ms);
+int  init_task_wait(struct init_task *task);
+int  init_task_run(struct init_task *task);
+void init_tasks_poll(void);
+void init_tasks_wait_all(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INIT_TASK_H */
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#include <string.h>
+
+#include <irq.h>
+
+#include "irq_stats.h"
+
+#ifdef IRQ_STATS_AVAILABLE
+
+static struct irq_stats irq_stats[CONFIG_CPU_INTERRUPTS];
+static uint32_t irq_stats_overhead = (uint32_t) -1; /* Cost of irq_stats_now() */
+
+static inline unsigned int irq_stats_bin(uint32_t cycles)
+{
+	unsigned int bin;
+
+	if (cycles == 0)
+		return 0;
+	bin = 32 - __builtin_clz(cycles);
+	return (bin < IRQ_STATS_BINS) ? bin : IRQ_STATS_BINS - 1;
+}
+
+static void irq_stats_calibrate(void)
+{
+	uint32_t t0, t1, overhead = (uint32_t) -1;
+	int i;
+
+	/* Minimum of a few back to back timestamps */
+	for (i = 0; i < 4; i++) {
+		t0 = irq_stats_now();
+		t1 = irq_stats_now();
+		if (t1 - t0 < overhead)
+			overhead = t1 - t0;
+	}
+	irq_stats_overhead = overhead;
+}
+
+/* Called from isr() (interrupts disabled) with the isr() entry, handler start and end timestamps. */
+void irq_stats_record(unsigned int irq, uint32_t entry, uint32_t start, uint32_t end)
+{
+	struct irq_stats *s = &irq_stats[irq];
+	uint32_t latency, duration;
+
+	if (irq_stats_overhead == (uint32_t) -1)
+		irq_stats_calibrate();
+	latency  = start - entry;
+	duration = end - start;
+	latency  = (latency  > irq_stats_overhead) ? latency  - irq_stats_overhead : 0;
+	duration = (duration > irq_stats_overhead) ? duration - irq_stats_overhead : 0;
+
+	s->count++;
+	s->duration_total += duration;
+	if (latency > s->latency_max)
+		s->latency_max = latency;
+	if (duration > s->duration_max)
+		s->duration_max = duration;
+	s->latency_hist[irq_stats_bin(latency)]++;
+	s->duration_hist[irq_stats_bin(duration)]++;
+}
+
+void irq_stats_reset(void)
+{
+	unsigned int ie;
+
+	ie = irq_getie();
+	irq_setie(0);
+	memset(irq_stats, 0, sizeof(irq_stats));
+	irq_setie(ie);
+}
+
+const struct irq_stats *irq_stats_get(unsigned int irq)
+{
+	if (irq >= CONFIG_CPU_INTERRUPTS)
+		return NULL;
+	return &irq_stats[irq];
+}
+
+#endif
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#ifndef __IRQ_STATS_H
+#define __IRQ_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <generated/csr.h>
+#include <generated/soc.h>
+
+/* Per-IRQ interrupt statistics (CONFIG_IRQ_STATS, e.g. soc.add_config("IRQ_STATS")): number of
+ * handler calls and log2 histograms of the entry latency (sys_clk cycles from isr() entry to the
+ * handler call: dispatch cost plus handlers run before it in the same isr() call) and of the
+ * handler duration. Timestamps come from the Timer0 uptime counter (timebase), with the
+ * cost of a timestamp subtracted.
+ */
+
+#if defined(CONFIG_IRQ_STATS) && defined(CONFIG_CPU_HAS_INTERRUPT) && defined(CSR_TIMER0_UPTIME_CYCLES_ADDR)
+#define IRQ_STATS_AVAILABLE
+#endif
+
+#ifdef IRQ_STATS_AVAILABLE
+
+/* Bin 0: 0 cycles, bin n: [2^(n-1), 2^n) cycles, last bin: 2^(IRQ_STATS_BINS-2) cycles and more. */
+#define IRQ_STATS_BINS 16
+
+struct irq_stats {
+	uint32_t count;
+	uint32_t latency_max;
+	uint32_t duration_max;
+	uint64_t duration_total;
+	uint32_t latency_hist[IRQ_STATS_BINS];
+	uint32_t duration_hist[IRQ_STATS_BINS];
+};
+
+/* Called with interrupts disabled; timebase_now() masks them around its own latch and read. */
+static inline uint32_t irq_stats_now(void)
+{
+	timer0_uptime_latch_write(1);
+	return (uint32_t) timer0_uptime_cycles_read();
+}
+
+void irq_stats_record(unsigned int irq, uint32_t entry, uint32_t start, uint32_t end);
+void irq_stats_reset(void);
+const struct irq_stats *irq_stats_get(unsigned int irq);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __IRQ_STATS_H */
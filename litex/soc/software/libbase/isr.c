@@ -7,6 +7,7 @@
 #include <generated/soc.h>
 #include <irq.h>
 #include <libbase/uart.h>
+#include <libbase/irq_stats.h>
 #include <stdio.h>
 
 #if defined(__microwatt__)
@@ -15,6 +16,9 @@ void isr_dec(void);
 #else
 void isr(void);
 #endif
+#if defined(__cv32e40p__) || defined(__cv32e41p__)
+void isr_firq(unsigned int irq);
+#endif
 
 #ifdef CONFIG_CPU_HAS_INTERRUPT
 
@@ -45,6 +49,31 @@ int irq_detach(unsigned int irq)
     return irq_attach(irq, NULL);
 }
 
+/* Handler call, with statistics (entry latency from isr() entry and duration) when enabled. */
+#ifdef IRQ_STATS_AVAILABLE
+static inline uint32_t irq_entry_time(void)
+{
+    return irq_stats_now();
+}
+
+static inline void irq_call(unsigned int irq, uint32_t entry)
+{
+    uint32_t start = irq_stats_now();
+    irq_table[irq].isr();
+    irq_stats_record(irq, entry, start, irq_stats_now());
+}
+#else
+static inline uint32_t irq_entry_time(void)
+{
+    return 0;
+}
+
+static inline void irq_call(unsigned int irq, uint32_t entry)
+{
+    irq_table[irq].isr();
+}
+#endif
+
 /***********************************************************/
 /* ISR and PLIC Initialization for RISC-V PLIC-based CPUs. */
 /***********************************************************/
@@ -69,12 +98,13 @@ void plic_init(void)
 void isr(void)
 {
     unsigned int claim;
+    uint32_t entry = irq_entry_time();
 
     /* Claim and handle pending interrupts. */
     while ((claim = *((unsigned int *)PLIC_CLAIM))) {
         unsigned int irq = claim - PLIC_EXT_IRQ_BASE;
         if (irq < CONFIG_CPU_INTERRUPTS && irq_table[irq].isr) {
-            irq_table[irq].isr();
+            irq_call(irq, entry);
         } else {
             /* Unhandled interrupt source, print diagnostic information. */
             printf("## PLIC: Unhandled claim: %d\n", claim);
@@ -103,16 +133,28 @@ void isr(void)
 #define ECALL 11
 #define RISCV_TEST
 
-/* Interrupt Service Routine. */
+/* Fast interrupts (FIRQ) Service Routine, called with the FIRQ number from its own mtvec vector
+   (see crt0.S): dispatched directly, without mcause decoding. */
+void isr_firq(unsigned int irq)
+{
+    uint32_t entry = irq_entry_time();
+
+    if (irq < CONFIG_CPU_INTERRUPTS && irq_table[irq].isr) {
+        irq_call(irq, entry);
+    }
+}
+
+/* Interrupt Service Routine (exceptions and non-vectored interrupts). */
 void isr(void)
 {
+    uint32_t entry = irq_entry_time();
     unsigned int cause = csrr(mcause) & IRQ_MASK;
 
     if (csrr(mcause) & 0x80000000) {
         /* Handle fast interrupts (FIRQ). */
         unsigned int irq = cause - FIRQ_OFFSET;
         if (irq < CONFIG_CPU_INTERRUPTS && irq_table[irq].isr) {
-            irq_table[irq].isr();
+            irq_call(irq, entry);
         }
     } else {
         /* Handle regular exceptions and system calls. */
@@ -159,6 +201,8 @@ void isr(uint64_t vec)
         return isr_dec();
 
     if (vec == 0x500) {
+        uint32_t entry = irq_entry_time();
+
         /* Read interrupt source. */
         uint32_t xirr = xics_icp_readw(PPC_XICS_XIRR);
         uint32_t irq_source = xirr & 0x00ffffff;
@@ -176,7 +220,7 @@ void isr(uint64_t vec)
             if (irqs) {
                 const unsigned int irq = __builtin_ctz(irqs);
                 if (irq < CONFIG_CPU_INTERRUPTS && irq_table[irq].isr) {
-                    irq_table[irq].isr();
+                    irq_call(irq, entry);
                 } else {
                     irq_setmask(irq_getmask() & ~(1 << irq));
                     printf("\n*** disabled spurious irq %d ***\n", irq);
@@ -206,12 +250,13 @@ void isr_dec(void)
 /* Interrupt Service Routine. */
 void isr(void)
 {
+    uint32_t entry = irq_entry_time();
     unsigned int irqs = irq_pending() & irq_getmask();
 
     while (irqs) {
         const unsigned int irq = __builtin_ctz(irqs);
         if ((irq < CONFIG_CPU_INTERRUPTS) && irq_table[irq].isr)
-            irq_table[irq].isr();
+            irq_call(irq, entry);
         else {
             irq_setmask(irq_getmask() & ~(1 << irq));
             printf("\n*** disabled spurious irq %d ***\n", irq);
@@ -228,6 +273,9 @@ void isr(uint64_t vec) {};
 #else
 void isr(void) {};
 #endif
+#if defined(__cv32e40p__) || defined(__cv32e41p__)
+void isr_firq(unsigned int irq) {};
+#endif
 
 #endif
 
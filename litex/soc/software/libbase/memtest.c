@@ -1,5 +1,6 @@
 #include "memtest.h"
 #include "lfsr.h"
+#include "timebase.h"
 
 #include <stdio.h>
 #include <system.h>
@@ -206,11 +207,13 @@ int memtest_data(unsigned int *addr, unsigned long size, int random, struct memt
 		for(i=0; i<size/4; i++) {
 			seed_32 = seed_to_data_32(seed_32, random);
 			array[i] = seed_32;
-			if (i%0x8000 == 0)
+			if (i%0x8000 == 0 && progress)
 				print_progress("  Write:", (unsigned long)addr, 4*i);
 		}
-		print_progress("  Write:", (unsigned long)addr, 4*i);
-		printf("\n");
+		if (progress) {
+			print_progress("  Write:", (unsigned long)addr, 4*i);
+			printf("\n");
+		}
 	}
 
 	/* Flush caches */
@@ -261,7 +264,7 @@ void memspeed(unsigned int *addr, unsigned long size, bool read_only, bool rando
 	volatile unsigned long *array = (unsigned long *)addr;
 	int i;
 	unsigned int seed_32 = 0;
-	uint32_t start, end;
+	uint64_t start, end;
 	unsigned long write_speed = 0;
 	unsigned long read_speed;
 	__attribute__((unused)) unsigned long data;
@@ -278,16 +281,9 @@ void memspeed(unsigned int *addr, unsigned long size, bool read_only, bool rando
 	print_size(size);
 	printf(")...\n");
 
-	/* Init timer */
-	timer0_en_write(0);
-	timer0_reload_write(0);
-	timer0_load_write(0xffffffff);
-	timer0_en_write(1);
-
 	/* Measure Write speed */
 	if (!read_only) {
-		timer0_update_value_write(1);
-		start = timer0_value_read();
+		start = timebase_now();
 
 		ptr = array;
 		do{
@@ -298,10 +294,9 @@ void memspeed(unsigned int *addr, unsigned long size, bool read_only, bool rando
 			ptr += burst_size;
 		} while(ptr <= ptr_max);
 
-		timer0_update_value_write(1);
-		end = timer0_value_read();
-		uint64_t numerator   = ((uint64_t)size)*((uint64_t)CONFIG_CLOCK_FREQUENCY);
-		uint64_t denominator = ((uint64_t)start - (uint64_t)end);
+		end = timebase_now();
+		uint64_t numerator   = ((uint64_t)size)*((uint64_t)TIMEBASE_FREQUENCY);
+		uint64_t denominator = end - start;
 		write_speed = numerator/denominator;
 		printf("  Write speed: ");
 		print_speed(write_speed);
@@ -313,9 +308,7 @@ void memspeed(unsigned int *addr, unsigned long size, bool read_only, bool rando
 	flush_l2_cache();
 
 	/* Measure Read speed */
-	timer0_en_write(1);
-	timer0_update_value_write(1);
-	start = timer0_value_read();
+	start = timebase_now();
 
 	int num = size/sz;
 
@@ -335,10 +328,9 @@ void memspeed(unsigned int *addr, unsigned long size, bool read_only, bool rando
 		} while(ptr <= ptr_max);
 	}
 
-	timer0_update_value_write(1);
-	end = timer0_value_read();
-	uint64_t numerator   = ((uint64_t)size)*((uint64_t)CONFIG_CLOCK_FREQUENCY);
-	uint64_t denominator = ((uint64_t)start - (uint64_t)end);
+	end = timebase_now();
+	uint64_t numerator   = ((uint64_t)size)*((uint64_t)TIMEBASE_FREQUENCY);
+	uint64_t denominator = end - start;
 	read_speed = numerator/denominator;
 	printf("   Read speed: ");
 	print_speed(read_speed);
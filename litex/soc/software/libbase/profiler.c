@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#include <stdio.h>
+#include <string.h>
+
+#include <irq.h>
+#include <system.h>
+
+#include "profiler.h"
+
+#ifdef PROFILER_AVAILABLE
+
+static struct profiler profiler;
+static int profiler_enabled;
+
+/* PC of the code interrupted by the sampling interrupt. */
+static inline unsigned long profiler_pc(void)
+{
+#if defined(__mor1kx__)
+	return mfspr(SPR_EPCR_BASE);
+#else
+	return csrr(mepc);
+#endif
+}
+
+static void profiler_isr(void)
+{
+	unsigned long offset;
+
+	timer0_ev_pending_write(timer0_ev_pending_read());
+
+	offset = (profiler_pc() - profiler.base) >> profiler.shift;
+	if (offset < profiler.buckets)
+		profiler.hist[offset]++;
+	else
+		profiler.outside++;
+	profiler.samples++;
+}
+
+void profiler_reset(void)
+{
+	unsigned int ie;
+
+	ie = irq_getie();
+	irq_setie(0);
+	memset(profiler.hist, 0, profiler.buckets*sizeof(uint32_t));
+	profiler.samples = 0;
+	profiler.outside = 0;
+	irq_setie(ie);
+}
+
+/* Start sampling [lo, hi) at rate Hz into hist (buckets entries); returns 0 on success. */
+int profiler_start(uint32_t *hist, unsigned int buckets, unsigned long lo, unsigned long hi, unsigned int rate)
+{
+	if ((irq_attach == NULL) || (hist == NULL) || (buckets == 0) || (hi <= lo))
+		return -1;
+	if (rate == 0)
+		rate = PROFILER_DEFAULT_RATE;
+
+	profiler_stop();
+
+	/* Smallest power of 2 bucket size covering the range (at least one 16-bit instruction) */
+	profiler.base    = lo;
+	profiler.shift   = 1;
+	profiler.buckets = buckets;
+	profiler.rate    = rate;
+	profiler.hist    = hist;
+	while ((profiler.shift < 8*sizeof(unsigned long) - 1) &&
+	       ((((unsigned long) buckets << profiler.shift) >> profiler.shift) == buckets) &&
+	       (((unsigned long) buckets << profiler.shift) < (hi - lo)))
+		profiler.shift++;
+	profiler_reset();
+
+	/* Periodic Timer0 interrupt */
+	timer0_en_write(0);
+	timer0_load_write(CONFIG_CLOCK_FREQUENCY/rate);
+	timer0_reload_write(CONFIG_CLOCK_FREQUENCY/rate);
+	timer0_ev_pending_write(timer0_ev_pending_read());
+	timer0_ev_enable_write(1);
+	irq_attach(TIMER0_INTERRUPT, profiler_isr);
+	irq_setmask(irq_getmask() | (1 << TIMER0_INTERRUPT));
+	timer0_en_write(1);
+	profiler_enabled = 1;
+
+	return 0;
+}
+
+void profiler_stop(void)
+{
+	if (!profiler_enabled)
+		return;
+	irq_setmask(irq_getmask() & ~(1 << TIMER0_INTERRUPT));
+	timer0_ev_enable_write(0);
+	timer0_en_write(0);
+	timer0_ev_pending_write(timer0_ev_pending_read());
+	irq_detach(TIMER0_INTERRUPT);
+	profiler_enabled = 0;
+}
+
+int profiler_running(void)
+{
+	return profiler_enabled;
+}
+
+const struct profiler *profiler_get(void)
+{
+	return &profiler;
+}
+
+/* Emit the histogram as text lines: a header, the non-empty buckets and an end marker. */
+void profiler_dump(profiler_emit emit, void *arg)
+{
+	char line[80];
+	unsigned int i;
+
+	if (profiler.hist == NULL)
+		return;
+
+	snprintf(line, sizeof(line), "prof: base=0x%08lx shift=%u buckets=%u rate=%u samples=%lu outside=%lu\n",
+		profiler.base, profiler.shift, profiler.buckets, profiler.rate,
+		(unsigned long) profiler.samples, (unsigned long) profiler.outside);
+	emit(line, arg);
+	for (i = 0; i < profiler.buckets; i++) {
+		if (profiler.hist[i] == 0)
+			continue;
+		snprintf(line, sizeof(line), "prof: 0x%08lx %lu\n",
+			profiler.base + ((unsigned long) i << profiler.shift),
+			(unsigned long) profiler.hist[i]);
+		emit(line, arg);
+	}
+	emit("prof: end\n", arg);
+}
+
+#endif
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#ifndef __PROFILER_H
+#define __PROFILER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <generated/csr.h>
+#include <generated/soc.h>
+
+/* Statistical profiler: a periodic Timer0 interrupt samples the interrupted PC and increments
+ * its bucket in a histogram covering [lo, hi), each bucket covering 2^shift bytes. Timer0 is
+ * used as the sampling timer (the timebase uses the Timer0 uptime counter), and the CPU must
+ * allow the interrupted PC to be read.
+ * profiler_dump() emits the histogram as text lines (to be symbolized on the host with
+ * litex_prof against the ELF).
+ */
+
+#if defined(CONFIG_CPU_HAS_INTERRUPT) && defined(TIMER0_INTERRUPT) && defined(CSR_TIMER0_UPTIME_CYCLES_ADDR) && \
+	((defined(__riscv) && !defined(__picorv32__)) || defined(__mor1kx__))
+#define PROFILER_AVAILABLE
+#endif
+
+#ifdef PROFILER_AVAILABLE
+
+#define PROFILER_DEFAULT_RATE 1000 /* Samples per second */
+
+struct profiler {
+	unsigned long     base;    /* Address of the first bucket.         */
+	unsigned int      shift;   /* log2 of the bucket size (in bytes).  */
+	unsigned int      buckets;
+	unsigned int      rate;
+	volatile uint32_t samples;
+	volatile uint32_t outside; /* Samples outside of [base, base + (buckets << shift)). */
+	uint32_t         *hist;
+};
+
+typedef void (*profiler_emit)(const char *line, void *arg);
+
+int  profiler_start(uint32_t *hist, unsigned int buckets, unsigned long lo, unsigned long hi, unsigned int rate);
+void profiler_stop(void);
+void profiler_reset(void);
+int  profiler_running(void);
+const struct profiler *profiler_get(void);
+void profiler_dump(profiler_emit emit, void *arg);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PROFILER_H */
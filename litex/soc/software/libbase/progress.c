@@ -36,6 +36,7 @@ void show_progress(int now)
 
 	if (now < 0) {
 		printf("%c\b", spinchr[spin++ % (sizeof(spinchr) - 1)]);
+		fflush(stdout);
 		return;
 	}
 
@@ -44,12 +45,15 @@ void show_progress(int now)
 		now = lldiv(tmp, progress_max).quot;
 	}
 
+	if (printed >= now)
+		return;
 	while (printed < now) {
 		if (!(printed % HASHES_PER_LINE) && printed)
 			printf("\n");
 		printf("#");
 		printed++;
 	}
+	fflush(stdout); /* Output is line buffered */
 }
 
 void init_progression_bar(int max)
@@ -59,4 +63,5 @@ void init_progression_bar(int max)
 	spin = 0;
 	if (progress_max && progress_max != FILESIZE_MAX)
 		printf("[%*s]\r[", HASHES_PER_LINE, "");
+	fflush(stdout);
 }
@@ -4,6 +4,8 @@
 #include <generated/mem.h>
 #include <generated/csr.h>
 
+#include <libbase/timebase.h>
+
 void flush_l2_cache(void)
 {
 #ifdef CONFIG_L2_SIZE
@@ -16,20 +18,10 @@ void flush_l2_cache(void)
 
 void busy_wait(unsigned int ms)
 {
-	timer0_en_write(0);
-	timer0_reload_write(0);
-	timer0_load_write(CONFIG_CLOCK_FREQUENCY/1000*ms);
-	timer0_en_write(1);
-	timer0_update_value_write(1);
-	while(timer0_value_read()) timer0_update_value_write(1);
+	timebase_delay_us((uint64_t) ms*1000);
 }
 
 void busy_wait_us(unsigned int us)
 {
-	timer0_en_write(0);
-	timer0_reload_write(0);
-	timer0_load_write(CONFIG_CLOCK_FREQUENCY/1000000*us);
-	timer0_en_write(1);
-	timer0_update_value_write(1);
-	while(timer0_value_read()) timer0_update_value_write(1);
+	timebase_delay_us(us);
 }
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#include <irq.h>
+
+#include <generated/csr.h>
+#include <generated/soc.h>
+
+#include "timebase.h"
+
+#ifndef CSR_TIMER0_UPTIME_CYCLES_ADDR
+#error "timebase requires the Timer0 uptime counter (enabled by default, remove --no-timer/--no-timer-uptime)"
+#endif
+
+uint64_t timebase_now(void)
+{
+	uint64_t ticks;
+#ifdef CONFIG_CPU_HAS_INTERRUPT
+	unsigned int ie;
+
+	/* Interrupt handlers also latch the counter (irq_stats_now()): keep latch and (multi-word)
+	   read together. */
+	ie = irq_getie();
+	irq_setie(0);
+#endif
+	timer0_uptime_latch_write(1);
+	ticks = timer0_uptime_cycles_read();
+#ifdef CONFIG_CPU_HAS_INTERRUPT
+	irq_setie(ie);
+#endif
+	return ticks;
+}
+
+uint64_t timebase_to_us(uint64_t ticks)
+{
+	return (ticks/TIMEBASE_FREQUENCY)*1000000 + ((ticks%TIMEBASE_FREQUENCY)*1000000)/TIMEBASE_FREQUENCY;
+}
+
+uint64_t timebase_from_us(uint64_t us)
+{
+#if (TIMEBASE_FREQUENCY % 1000000) == 0
+	/* Avoid a 64-bit division in delays/timeouts for integer MHz clocks */
+	return us*(TIMEBASE_FREQUENCY/1000000);
+#else
+	return (us/1000000)*TIMEBASE_FREQUENCY + ((us%1000000)*TIMEBASE_FREQUENCY)/1000000;
+#endif
+}
+
+void timebase_delay_us(uint64_t us)
+{
+	uint64_t deadline;
+
+	deadline = timebase_deadline_us(us);
+	while (!timebase_expired(deadline));
+}
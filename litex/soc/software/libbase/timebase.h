@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#ifndef __TIMEBASE_H
+#define __TIMEBASE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <generated/soc.h>
+
+/* 64-bit monotonic timebase in sys_clk cycles (ticks), for delays, timeouts and measurements.
+ *
+ * Reads the Timer0 uptime counter (enabled by default, see --no-timer-uptime), leaving the Timer0
+ * countdown (and its interrupt) to the application.
+ */
+
+#define TIMEBASE_FREQUENCY CONFIG_CLOCK_FREQUENCY
+
+uint64_t timebase_now(void);
+uint64_t timebase_to_us(uint64_t ticks);
+uint64_t timebase_from_us(uint64_t us);
+
+/* Deadline helpers: d = timebase_deadline_us(us); while (!timebase_expired(d)) ... */
+static inline uint64_t timebase_deadline_us(uint64_t us)
+{
+	return timebase_now() + timebase_from_us(us);
+}
+
+static inline int timebase_expired(uint64_t deadline)
+{
+	return timebase_now() >= deadline;
+}
+
+void timebase_delay_us(uint64_t us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIMEBASE_H */
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#include <stdio.h>
+
+#include "timebase.h"
+#include "trace.h"
+
+struct trace_log trace_log;
+
+void trace_reset(void)
+{
+	trace_log.magic = TRACE_LOG_MAGIC;
+	trace_log.count = 0;
+}
+
+void trace_point(const char *name)
+{
+	struct trace_point *point;
+
+	if (trace_log.magic != TRACE_LOG_MAGIC)
+		trace_reset();
+	if (trace_log.count >= TRACE_MAX_POINTS)
+		return;
+	point = &trace_log.points[trace_log.count++];
+	point->name   = name;
+	point->cycles = timebase_now();
+}
+
+void trace_summary(void)
+{
+	uint64_t now, start, end;
+	unsigned i;
+
+	if ((trace_log.magic != TRACE_LOG_MAGIC) || (trace_log.count == 0))
+		return;
+
+	now = timebase_now();
+	printf("Boot time @0x%08lx (%d points):\n", (unsigned long) &trace_log, (int) trace_log.count);
+	for (i=0; i<trace_log.count; i++) {
+		start = trace_log.points[i].cycles;
+		end   = (i + 1 < trace_log.count) ? trace_log.points[i + 1].cycles : now;
+		printf("  %-20s @%10lu us: %10lu us\n",
+			trace_log.points[i].name,
+			(unsigned long) timebase_to_us(start),
+			(unsigned long) timebase_to_us(end - start));
+	}
+	printf("  %-20s @%10lu us\n", "now", (unsigned long) timebase_to_us(now));
+}
@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#ifndef __TRACE_H
+#define __TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* Lightweight tracepoints: trace_point(name) records the start of phase "name" with a timebase
+ * timestamp (sys_clk cycles) in a RAM log; the phase ends at the next tracepoint.
+ * trace_summary() prints the per-phase breakdown. The log (trace_log) starts with a magic word
+ * so it can also be located and read from the host (litex_client/Etherbone/JTAG).
+ */
+
+#ifndef TRACE_MAX_POINTS
+#define TRACE_MAX_POINTS 32
+#endif
+
+#define TRACE_LOG_MAGIC 0x54524345 /* "TRCE" */
+
+struct trace_point {
+	const char *name;
+	uint64_t    cycles;
+};
+
+struct trace_log {
+	uint32_t magic;
+	uint32_t count;
+	struct trace_point points[TRACE_MAX_POINTS];
+};
+
+extern struct trace_log trace_log;
+
+void trace_point(const char *name);
+void trace_reset(void);
+void trace_summary(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TRACE_H */
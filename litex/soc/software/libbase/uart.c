@@ -14,31 +14,51 @@
 
 #ifndef UART_POLLING
 
-#define UART_RINGBUFFER_SIZE_RX 128
+#ifndef UART_RINGBUFFER_SIZE_RX
+#define UART_RINGBUFFER_SIZE_RX 256
+#endif
 #define UART_RINGBUFFER_MASK_RX (UART_RINGBUFFER_SIZE_RX-1)
 
+#ifndef UART_RINGBUFFER_SIZE_TX
+#define UART_RINGBUFFER_SIZE_TX 256
+#endif
+#define UART_RINGBUFFER_MASK_TX (UART_RINGBUFFER_SIZE_TX-1)
+
+#if (UART_RINGBUFFER_SIZE_RX & UART_RINGBUFFER_MASK_RX) || (UART_RINGBUFFER_SIZE_TX & UART_RINGBUFFER_MASK_TX)
+#error "UART ring buffer sizes must be a power of 2"
+#endif
+
 static char rx_buf[UART_RINGBUFFER_SIZE_RX];
 static volatile unsigned int rx_produce;
 static unsigned int rx_consume;
 
-#define UART_RINGBUFFER_SIZE_TX 128
-#define UART_RINGBUFFER_MASK_TX (UART_RINGBUFFER_SIZE_TX-1)
-
 static char tx_buf[UART_RINGBUFFER_SIZE_TX];
 static unsigned int tx_produce;
 static volatile unsigned int tx_consume;
 
+/* Move queued TX bytes to the UART FIFO until it is full. */
+static void uart_tx_drain(void)
+{
+	while((tx_consume != tx_produce) && !uart_txfull_read()) {
+		uart_rxtx_write(tx_buf[tx_consume]);
+		tx_consume = (tx_consume + 1) & UART_RINGBUFFER_MASK_TX;
+	}
+}
+
 void uart_isr(void)
 {
 	unsigned int stat, rx_produce_next;
+	char c;
 
 	stat = uart_ev_pending_read();
 
 	if(stat & UART_EV_RX) {
 		while(!uart_rxempty_read()) {
+			/* Drop the byte when the ring is full (do not stall in the ISR) */
+			c = uart_rxtx_read();
 			rx_produce_next = (rx_produce + 1) & UART_RINGBUFFER_MASK_RX;
 			if(rx_produce_next != rx_consume) {
-				rx_buf[rx_produce] = uart_rxtx_read();
+				rx_buf[rx_produce] = c;
 				rx_produce = rx_produce_next;
 			}
 			uart_ev_pending_write(UART_EV_RX);
@@ -50,10 +70,7 @@ void uart_isr(void)
 
 	if(stat & UART_EV_TX) {
 		uart_ev_pending_write(UART_EV_TX);
-		while((tx_consume != tx_produce) && !uart_txfull_read()) {
-			uart_rxtx_write(tx_buf[tx_consume]);
-			tx_consume = (tx_consume + 1) & UART_RINGBUFFER_MASK_TX;
-		}
+		uart_tx_drain();
 	}
 }
 
@@ -73,31 +90,56 @@ char uart_read(void)
 	return c;
 }
 
+/* Copy up to len received bytes to buf, returns the number of bytes copied (non-blocking). */
+unsigned int uart_read_buf(char *buf, unsigned int len)
+{
+	unsigned int n;
+
+	for(n = 0; (n < len) && (rx_consume != rx_produce); n++) {
+		buf[n] = rx_buf[rx_consume];
+		rx_consume = (rx_consume + 1) & UART_RINGBUFFER_MASK_RX;
+	}
+	return n;
+}
+
 int uart_read_nonblock(void)
 {
 	return (rx_consume != rx_produce);
 }
 
-void uart_write(char c)
+/* Do not use in interrupt handlers! */
+void uart_write_buf(const char *buf, unsigned int len)
 {
 	unsigned int oldmask;
-	unsigned int tx_produce_next = (tx_produce + 1) & UART_RINGBUFFER_MASK_TX;
 
-	if(irq_getie()) {
-		while(tx_produce_next == tx_consume);
-	} else if(tx_produce_next == tx_consume) {
-		return;
-	}
+	while(len) {
+		/* Wait for room in the ring; with interrupts disabled, drain it ourselves */
+		while(((tx_produce + 1) & UART_RINGBUFFER_MASK_TX) == tx_consume) {
+			if(!irq_getie())
+				uart_tx_drain();
+		}
 
-	oldmask = irq_getmask();
-	irq_setmask(oldmask & ~(1 << UART_INTERRUPT));
-	if((tx_consume != tx_produce) || uart_txfull_read()) {
-		tx_buf[tx_produce] = c;
-		tx_produce = tx_produce_next;
-	} else {
-		uart_rxtx_write(c);
+		/* Fill the FIFO directly when nothing is queued, then queue what fits in the ring */
+		oldmask = irq_getmask();
+		irq_setmask(oldmask & ~(1 << UART_INTERRUPT));
+		if(tx_consume == tx_produce) {
+			while(len && !uart_txfull_read()) {
+				uart_rxtx_write(*buf++);
+				len--;
+			}
+		}
+		while(len && (((tx_produce + 1) & UART_RINGBUFFER_MASK_TX) != tx_consume)) {
+			tx_buf[tx_produce] = *buf++;
+			tx_produce = (tx_produce + 1) & UART_RINGBUFFER_MASK_TX;
+			len--;
+		}
+		irq_setmask(oldmask);
 	}
-	irq_setmask(oldmask);
+}
+
+void uart_write(char c)
+{
+	uart_write_buf(&c, 1);
 }
 
 void uart_init(void)
@@ -117,7 +159,10 @@ void uart_init(void)
 
 void uart_sync(void)
 {
-	while(tx_consume != tx_produce);
+	while(tx_consume != tx_produce) {
+		if(!irq_getie())
+			uart_tx_drain();
+	}
 }
 
 #else
@@ -135,6 +180,17 @@ char uart_read(void)
 	return c;
 }
 
+unsigned int uart_read_buf(char *buf, unsigned int len)
+{
+	unsigned int n;
+
+	for(n = 0; (n < len) && !uart_rxempty_read(); n++) {
+		buf[n] = uart_rxtx_read();
+		uart_ev_pending_write(UART_EV_RX);
+	}
+	return n;
+}
+
 int uart_read_nonblock(void)
 {
 	return (uart_rxempty_read() == 0);
@@ -147,6 +203,12 @@ void uart_write(char c)
 	uart_ev_pending_write(UART_EV_TX);
 }
 
+void uart_write_buf(const char *buf, unsigned int len)
+{
+	while (len--)
+		uart_write(*buf++);
+}
+
 void uart_init(void)
 {
 	uart_ev_pending_write(uart_ev_pending_read());
@@ -16,6 +16,11 @@ void uart_write(char c);
 char uart_read(void);
 int uart_read_nonblock(void);
 
+/* Block transfers: uart_write_buf blocks until all bytes are queued, uart_read_buf copies the
+   bytes already received (non-blocking) and returns their number. */
+void uart_write_buf(const char *buf, unsigned int len);
+unsigned int uart_read_buf(char *buf, unsigned int len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -11,14 +11,44 @@
 
 #include <generated/csr.h>
 
+/*
+ * Output is line buffered: characters are accumulated and sent to the UART as a block (a single
+ * uart_write_buf call) on end of line, when the buffer is full, on fflush() or before reading.
+ * Partial lines (progress messages such as "Initialize SDCard... ") followed by a long operation
+ * must be flushed explicitly by the caller with fflush(stdout).
+ */
+
+#ifndef STDIO_BUFFER_SIZE
+#define STDIO_BUFFER_SIZE 128
+#endif
+
+#ifdef CSR_UART_BASE
+static char stdio_buf[STDIO_BUFFER_SIZE];
+static unsigned int stdio_len;
+#endif
+
 static int
-litex_putc(char c, FILE *file)
+litex_flush(FILE *file)
 {
 	(void) file; /* Not used in this function */
 #ifdef CSR_UART_BASE
-	uart_write(c);
+	if (stdio_len) {
+		uart_write_buf(stdio_buf, stdio_len);
+		stdio_len = 0;
+	}
+#endif
+	return 0;
+}
+
+static int
+litex_putc(char c, FILE *file)
+{
+#ifdef CSR_UART_BASE
+	stdio_buf[stdio_len++] = c;
 	if (c == '\n')
-		litex_putc('\r', NULL);
+		stdio_buf[stdio_len++] = '\r';
+	if ((c == '\n') || (c == '\r') || (stdio_len >= STDIO_BUFFER_SIZE - 1))
+		litex_flush(file);
 #endif
 	return c;
 }
@@ -26,7 +56,7 @@ litex_putc(char c, FILE *file)
 static int
 litex_getc(FILE *file)
 {
-	(void) file; /* Not used in this function */
+	litex_flush(file);
 	while(1) {
 #ifdef CSR_UART_BASE
 		if(uart_read_nonblock())
@@ -36,7 +66,7 @@ litex_getc(FILE *file)
 	return -1;
 }
 
-static FILE __stdio = FDEV_SETUP_STREAM(litex_putc, litex_getc, NULL, _FDEV_SETUP_RW);
+static FILE __stdio = FDEV_SETUP_STREAM(litex_putc, litex_getc, litex_flush, _FDEV_SETUP_RW);
 
 FILE *const stdout = &__stdio;
 FILE *const stderr = &__stdio;
@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#include <stdint.h>
+#include <string.h>
+
+#include <generated/soc.h>
+
+#include "ff.h"
+#include "diskio.h"
+#include "diskcache.h"
+
+#define FATFS_CACHE_BLOCK_SIZE (FATFS_CACHE_BLOCK_SECTORS*FF_MAX_SS)
+
+struct fatfs_cache_tag {
+	LBA_t    sector;
+	uint32_t stamp;
+	uint8_t  valid;
+};
+
+static struct fatfs_cache_tag *cache_tags;
+static BYTE     *cache_data;
+static unsigned  cache_nblocks;
+static uint32_t  cache_stamp;
+static LBA_t     cache_last_miss;
+static DISKOPS  *cache_backend;
+static struct fatfs_cache_stats cache_stats;
+
+/*-----------------------------------------------------------------------*/
+/* Cache management                                                      */
+/*-----------------------------------------------------------------------*/
+
+void fatfs_cache_init(void *base, unsigned long size)
+{
+	/* The region holds the tags followed by the (sector aligned) blocks. */
+	cache_nblocks = size/(sizeof(struct fatfs_cache_tag) + FATFS_CACHE_BLOCK_SIZE);
+	cache_tags    = (struct fatfs_cache_tag *) base;
+	cache_data    = (BYTE *) base + size - cache_nblocks*FATFS_CACHE_BLOCK_SIZE;
+	fatfs_cache_invalidate();
+}
+
+void fatfs_cache_invalidate(void)
+{
+	unsigned i;
+	for (i=0; i<cache_nblocks; i++)
+		cache_tags[i].valid = 0;
+	cache_last_miss = (LBA_t) -1;
+	memset(&cache_stats, 0, sizeof(cache_stats));
+}
+
+void fatfs_cache_get_stats(struct fatfs_cache_stats *stats)
+{
+	*stats = cache_stats;
+}
+
+static int cache_lookup(LBA_t block_sector)
+{
+	unsigned i;
+	for (i=0; i<cache_nblocks; i++)
+		if (cache_tags[i].valid && (cache_tags[i].sector == block_sector))
+			return i;
+	return -1;
+}
+
+static unsigned cache_victim(void)
+{
+	unsigned i, victim = 0;
+	for (i=0; i<cache_nblocks; i++) {
+		if (!cache_tags[i].valid)
+			return i;
+		if ((int32_t)(cache_tags[i].stamp - cache_tags[victim].stamp) < 0)
+			victim = i;
+	}
+	return victim;
+}
+
+/* Read-ahead slot: invalid, or not used more recently than the (valid) LRU victim. */
+static int cache_cold(unsigned slot, unsigned victim)
+{
+	if (!cache_tags[slot].valid)
+		return 1;
+	return cache_tags[victim].valid &&
+		((int32_t)(cache_tags[slot].stamp - cache_tags[victim].stamp) <= 0);
+}
+
+static int cache_fill(BYTE pdrv, LBA_t block_sector)
+{
+	unsigned victim, nblocks, i;
+
+	/* Sequential miss: read ahead the next blocks in the same transfer, into the consecutive
+	   slots following the LRU victim as long as they are cold (hot FAT/directory blocks are
+	   never evicted by the read-ahead). */
+	victim  = cache_victim();
+	nblocks = 1;
+	if (block_sector == cache_last_miss + FATFS_CACHE_BLOCK_SECTORS) {
+		while ((nblocks < FATFS_CACHE_READAHEAD) &&
+		       (victim + nblocks < cache_nblocks) &&
+		       cache_cold(victim + nblocks, victim))
+			nblocks++;
+	}
+	cache_last_miss = block_sector + (nblocks - 1)*FATFS_CACHE_BLOCK_SECTORS;
+
+	/* Drop any stale copy of the read-ahead blocks before reusing their slots. */
+	for (i=1; i<nblocks; i++) {
+		int slot = cache_lookup(block_sector + i*FATFS_CACHE_BLOCK_SECTORS);
+		if (slot >= 0)
+			cache_tags[slot].valid = 0;
+	}
+
+	cache_stats.reads++;
+	cache_stats.sectors += nblocks*FATFS_CACHE_BLOCK_SECTORS;
+	for (i=0; i<nblocks; i++)
+		cache_tags[victim + i].valid = 0;
+	if (cache_backend->disk_read(pdrv, cache_data + victim*FATFS_CACHE_BLOCK_SIZE,
+		block_sector, nblocks*FATFS_CACHE_BLOCK_SECTORS) != RES_OK)
+		return -1;
+	for (i=0; i<nblocks; i++) {
+		cache_tags[victim + i].sector = block_sector + i*FATFS_CACHE_BLOCK_SECTORS;
+		cache_tags[victim + i].stamp  = cache_stamp;
+		cache_tags[victim + i].valid  = 1;
+	}
+	return victim;
+}
+
+/*-----------------------------------------------------------------------*/
+/* Cache FatFs disk functions                                            */
+/*-----------------------------------------------------------------------*/
+
+static DSTATUS cache_disk_status(BYTE pdrv) {
+	return cache_backend->disk_status(pdrv);
+}
+
+static DSTATUS cache_disk_initialize(BYTE pdrv) {
+	DSTATUS status;
+	status = cache_backend->disk_initialize(pdrv);
+	if (status & STA_NOINIT)
+		fatfs_cache_invalidate();
+	return status;
+}
+
+static DRESULT cache_disk_read(BYTE pdrv, BYTE *buf, LBA_t sector, UINT count) {
+	LBA_t block_sector;
+	int slot;
+
+	/* Large requests: bypass the cache. */
+	if (count >= FATFS_CACHE_BLOCK_SECTORS) {
+		cache_stats.reads++;
+		cache_stats.sectors += count;
+		return cache_backend->disk_read(pdrv, buf, sector, count);
+	}
+
+	while (count > 0) {
+		block_sector = sector - (sector % FATFS_CACHE_BLOCK_SECTORS);
+		slot = cache_lookup(block_sector);
+		if (slot < 0) {
+			cache_stats.misses++;
+			slot = cache_fill(pdrv, block_sector);
+			if (slot < 0)
+				return RES_ERROR;
+		} else
+			cache_stats.hits++;
+		cache_tags[slot].stamp = ++cache_stamp;
+		memcpy(buf, cache_data + slot*FATFS_CACHE_BLOCK_SIZE + (sector - block_sector)*FF_MAX_SS, FF_MAX_SS);
+		buf += FF_MAX_SS;
+		sector++;
+		count--;
+	}
+	return RES_OK;
+}
+
+static DISKOPS CacheDiskOps = {
+	.disk_initialize = cache_disk_initialize,
+	.disk_status = cache_disk_status,
+	.disk_read = cache_disk_read,
+};
+
+void fatfs_set_ops_cache(void) {
+#if defined(CONFIG_FATFS_CACHE_BASE) && defined(CONFIG_FATFS_CACHE_SIZE)
+	if (cache_nblocks == 0)
+		fatfs_cache_init((void *) CONFIG_FATFS_CACHE_BASE, CONFIG_FATFS_CACHE_SIZE);
+#endif
+	/* No cache region: keep the driver's ops. */
+	if ((cache_nblocks == 0) || (FfDiskOps == &CacheDiskOps))
+		return;
+	cache_backend = FfDiskOps;
+	fatfs_cache_invalidate();
+	FfDiskOps = &CacheDiskOps;
+}
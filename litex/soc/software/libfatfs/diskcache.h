@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#ifndef __DISKCACHE_H
+#define __DISKCACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "diskio.h"
+
+/*-----------------------------------------------------------------------*/
+/* FatFs disk cache                                                      */
+/*-----------------------------------------------------------------------*/
+
+/* Optional LRU block cache inserted between FatFs and the disk driver (FfDiskOps). The cache
+   is stored in a RAM region given to fatfs_cache_init() or, by default, in the region defined
+   by CONFIG_FATFS_CACHE_BASE/CONFIG_FATFS_CACHE_SIZE (soc.add_config()).
+
+   Small requests (FAT/directory/boot.json sectors) are served from cached blocks of
+   FATFS_CACHE_BLOCK_SECTORS sectors; misses fill a whole block with a single multi-block
+   read and sequential misses read several blocks ahead (into cold slots only). Large
+   requests (file data read directly to the user buffer) bypass the cache. */
+
+#ifndef FATFS_CACHE_BLOCK_SECTORS
+#define FATFS_CACHE_BLOCK_SECTORS 8
+#endif
+
+#ifndef FATFS_CACHE_READAHEAD
+#define FATFS_CACHE_READAHEAD 4
+#endif
+
+struct fatfs_cache_stats {
+	uint32_t hits;
+	uint32_t misses;
+	uint32_t reads;
+	uint32_t sectors;
+};
+
+void fatfs_cache_init(void *base, unsigned long size);
+void fatfs_cache_invalidate(void);
+void fatfs_cache_get_stats(struct fatfs_cache_stats *stats);
+void fatfs_set_ops_cache(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DISKCACHE_H */
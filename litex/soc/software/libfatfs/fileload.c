@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <libbase/progress.h>
+
+#include "ff.h"
+#include "diskio.h"
+#include "fileload.h"
+
+#ifndef min
+#define min(x, y) (((x) < (y)) ? (x) : (y))
+#endif
+
+/*-----------------------------------------------------------------------*/
+/* FatFs file loading                                                    */
+/*-----------------------------------------------------------------------*/
+
+static DWORD fatfs_clmt[2*FATFS_CLMT_FRAGMENTS + 2];
+
+static int fatfs_copy_file_to_ram_fast(FIL *file, unsigned long ram_address, uint32_t *offset)
+{
+	DWORD *frag;
+	FATFS *fs;
+	FSIZE_t length;
+	LBA_t sector;
+	uint32_t nsectors;
+	uint32_t count;
+
+	/* Build the Cluster Link Map Table: one (length, cluster) entry per contiguous fragment. */
+	fatfs_clmt[0] = sizeof(fatfs_clmt)/sizeof(fatfs_clmt[0]);
+	file->cltbl = fatfs_clmt;
+	if (f_lseek(file, CREATE_LINKMAP) != FR_OK) {
+		file->cltbl = 0;
+		return 0;
+	}
+
+	/* Read full sectors of each fragment directly to RAM with multi-sector requests. */
+	fs     = file->obj.fs;
+	length = f_size(file);
+	for (frag = &fatfs_clmt[1]; (frag[0] != 0) && (*offset < length); frag += 2) {
+		sector   = fs->database + (LBA_t)fs->csize*(frag[1] - 2);
+		nsectors = min((FSIZE_t)frag[0]*fs->csize, (length - *offset)/FF_MAX_SS);
+		while (nsectors > 0) {
+			count = min(nsectors, FATFS_MAX_READ_SECTORS);
+			if (FfDiskOps->disk_read(fs->pdrv, (BYTE *)(ram_address + *offset), sector, count) != RES_OK)
+				return -1;
+			sector   += count;
+			nsectors -= count;
+			*offset  += count*FF_MAX_SS;
+			show_progress(*offset);
+		}
+		/* Partial last sector: let f_read do it. */
+		if ((length - *offset) < FF_MAX_SS)
+			break;
+	}
+
+	/* Position the file after the data already loaded. */
+	if (f_lseek(file, *offset) != FR_OK)
+		return -1;
+	return 1;
+}
+
+int fatfs_copy_file_to_ram(const char *filename, unsigned long ram_address)
+{
+	FRESULT fr;
+	FATFS fs;
+	FIL file;
+	uint32_t br;
+	uint32_t offset;
+	unsigned long length;
+
+	fr = f_mount(&fs, "", 1);
+	if (fr != FR_OK)
+		return 0;
+	fr = f_open(&file, filename, FA_READ);
+	if (fr != FR_OK) {
+		printf("%s file not found.\n", filename);
+		f_mount(0, "", 0);
+		return 0;
+	}
+
+	length = f_size(&file);
+	printf("Copying %s to 0x%08lx (%ld bytes)...\n", filename, ram_address, length);
+	init_progression_bar(length);
+	offset = 0;
+	if (fatfs_copy_file_to_ram_fast(&file, ram_address, &offset) < 0) {
+		printf("file read error.\n");
+		f_close(&file);
+		f_mount(0, "", 0);
+		return 0;
+	}
+	for (;;) {
+		fr = f_read(&file, (void*) ram_address + offset,  0x8000, (UINT *)&br);
+		if (fr != FR_OK) {
+			printf("file read error.\n");
+			f_close(&file);
+			f_mount(0, "", 0);
+			return 0;
+		}
+		if (br == 0)
+			break;
+		offset += br;
+		show_progress(offset);
+	}
+	show_progress(offset);
+	printf("\n");
+
+	f_close(&file);
+	f_mount(0, "", 0);
+
+	return 1;
+}
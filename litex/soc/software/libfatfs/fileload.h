@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#ifndef __FILELOAD_H
+#define __FILELOAD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "diskio.h"
+
+/*-----------------------------------------------------------------------*/
+/* FatFs file loading                                                    */
+/*-----------------------------------------------------------------------*/
+
+/* Max number of fragments of a file loaded through the fast path (files with more fragments are
+   loaded through f_read). */
+#ifndef FATFS_CLMT_FRAGMENTS
+#define FATFS_CLMT_FRAGMENTS 32
+#endif
+
+/* Max number of sectors per disk read request (also progress bar update granularity). */
+#ifndef FATFS_MAX_READ_SECTORS
+#define FATFS_MAX_READ_SECTORS 2048
+#endif
+
+/* Copy a file of the volume (using the current FfDiskOps) to RAM. Returns 1 on success, 0 on
+   error. */
+int fatfs_copy_file_to_ram(const char *filename, unsigned long ram_address);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FILELOAD_H */
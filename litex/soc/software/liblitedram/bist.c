@@ -57,7 +57,11 @@ static uint32_t pseudo_random_bases[128] = {
 	0x00027e36,0x000e51ae,0x002e7627,0x00275c9f,
 };
 
-static void sdram_bist_write(uint32_t base, uint32_t length) {
+/* Write/read (check) length bytes of random data at base with the generator/checker. Return 1 when
+ * done, 0 if still running after timeout status polls (0: no timeout). */
+static int sdram_bist_write(uint32_t base, uint32_t length, unsigned int timeout) {
+	unsigned int i;
+
 	/* Prepare write */
 	sdram_generator_reset_write(1);
 	sdram_generator_random_write(1); /* Random data */
@@ -69,10 +73,15 @@ static void sdram_bist_write(uint32_t base, uint32_t length) {
 	sdram_generator_start_write(1);
 
 	/* Wait write */
-	while(sdram_generator_done_read() == 0);
+	for (i = 0; (timeout == 0) || (i < timeout); i++)
+		if (sdram_generator_done_read())
+			return 1;
+	return 0;
 }
 
-static void sdram_bist_read(uint32_t base, uint32_t length) {
+static int sdram_bist_read(uint32_t base, uint32_t length, unsigned int timeout) {
+	unsigned int i;
+
 	/* Prepare read */
 	sdram_checker_reset_write(1);
 	sdram_checker_random_write(1); /* Random data */
@@ -81,10 +90,31 @@ static void sdram_bist_read(uint32_t base, uint32_t length) {
 	sdram_checker_length_write(length);
 
 	/* Start read */
-
 	sdram_checker_start_write(1);
+
 	/* Wait read */
-	while(sdram_checker_done_read() == 0);
+	for (i = 0; (timeout == 0) || (i < timeout); i++)
+		if (sdram_checker_done_read())
+			return 1;
+	return 0;
+}
+
+#define SDRAM_BIST_CHECK_TIMEOUT 100000
+
+/* Write a burst of burst_length random words with the generator and verify it with the checker
+ * (used by the leveling routines, with the controller in hardware control). Returns the number of
+ * erroneous words (burst_length on timeout). */
+unsigned int sdram_bist_check(uint32_t base, uint32_t burst_length) {
+	unsigned int errors;
+	uint32_t length;
+	length = burst_length * SDRAM_TEST_DATA_BYTES;
+
+	errors = burst_length;
+	if (sdram_bist_write(base, length, SDRAM_BIST_CHECK_TIMEOUT) &&
+	    sdram_bist_read(base, length, SDRAM_BIST_CHECK_TIMEOUT))
+		errors = sdram_checker_errors_read();
+
+	return errors < burst_length ? errors : burst_length;
 }
 
 static void sdram_bist_loop(uint32_t loop, uint32_t burst_length, uint32_t random) {
@@ -100,12 +130,12 @@ static void sdram_bist_loop(uint32_t loop, uint32_t burst_length, uint32_t rando
 		else
 			base = SDRAM_TEST_BASE + ((i+loop)%128)*SDRAM_TEST_DATA_BYTES;
 
-		sdram_bist_write(base, length);
+		sdram_bist_write(base, length, 0);
 		/* Get write results */
 		wr_length += length;
 		wr_ticks += sdram_generator_ticks_read();
 
-		sdram_bist_read(base, length);
+		sdram_bist_read(base, length, 0);
 		/* Get read results */
 		rd_length += length;
 		rd_ticks  += sdram_checker_ticks_read();
@@ -188,9 +218,9 @@ int sdram_hw_test(uint64_t origin, uint64_t size, uint64_t burst_length) {
 		if (burst_size < SDRAM_TEST_DATA_BYTES || old_burst_size < burst_size)
 			break;
 
-		sdram_bist_write(address, burst_size);
+		sdram_bist_write(address, burst_size, 0);
 
-		sdram_bist_read(address, burst_size);
+		sdram_bist_read(address, burst_size, 0);
 		errors += sdram_checker_errors_read();
 
 		print_progress("  SDRAM HW test:", origin, address - origin + burst_size);
@@ -12,6 +12,7 @@ extern "C" {
 
 void sdram_bist(uint32_t burst_length, uint32_t random);
 int sdram_hw_test(uint64_t origin, uint64_t size, uint64_t burst_length);
+unsigned int sdram_bist_check(uint32_t base, uint32_t burst_length);
 
 #ifdef __cplusplus
 }
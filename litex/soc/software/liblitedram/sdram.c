@@ -15,9 +15,12 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <libbase/memtest.h>
 #include <libbase/lfsr.h>
+#include <libbase/init_task.h>
+#include <libbase/trace.h>
 
 #include <generated/sdram_phy.h>
 #include <generated/mem.h>
@@ -25,7 +28,9 @@
 
 #include <liblitedram/sdram.h>
 #include <liblitedram/sdram_dbg.h>
+#include <liblitedram/bist.h>
 #include <liblitedram/accessors.h>
+#include <liblitedram/utils.h>
 
 //#define SDRAM_TEST_DISABLE
 //#define SDRAM_WRITE_LEVELING_CMD_DELAY_DEBUG
@@ -421,8 +426,72 @@ static unsigned int sdram_write_read_check_test_pattern(int module, unsigned int
 static int _seed_array[] = {42, 84, 36};
 static int _seed_array_length = sizeof(_seed_array) / sizeof(_seed_array[0]);
 
+/* With the LiteDRAM BIST (--with-sdram-bist), a burst of SDRAM_LEVELING_BIST_LENGTH random words
+ * is written/verified by the generator/checker instead of the DFII software pattern check. The
+ * checker only returns a global error count (no per-module data mask), so it is only used when the
+ * errors can be attributed to the module under test, i.e. when all the other modules are known to
+ * work at their current delays (modules centered by sdram_leveling_center_module): for the last
+ * module to be centered (and single-module PHYs), where it also acts as a final validation of the
+ * whole data path through the controller. The DFII check is used for the other modules. */
+#if defined(CSR_SDRAM_GENERATOR_BASE) && defined(CSR_SDRAM_CHECKER_BASE) && !defined(SDRAM_DELAY_PER_DQ)
+#define SDRAM_LEVELING_BIST
+#ifndef SDRAM_LEVELING_BIST_LENGTH
+#define SDRAM_LEVELING_BIST_LENGTH 64
+#endif
+
+static unsigned int _sdram_leveling_modules_ok;
+
+static void sdram_leveling_module_ok(int module, int ok) {
+	if (ok)
+		_sdram_leveling_modules_ok |= 1u << module;
+	else
+		_sdram_leveling_modules_ok &= ~(1u << module);
+}
+
+static int run_test_pattern_bist(int module) {
+	const unsigned int max_errors = _seed_array_length*READ_CHECK_TEST_PATTERN_MAX_ERRORS;
+	unsigned int errors;
+
+#if defined(SDRAM_PHY_ECP5DDRPHY) || defined(SDRAM_PHY_GW2DDRPHY)
+	ddrphy_burstdet_clr_write(1);
+#endif // defined(SDRAM_PHY_ECP5DDRPHY) || defined(SDRAM_PHY_GW2DDRPHY)
+
+	sdram_dfii_control_write(DFII_CONTROL_HARDWARE);
+	errors = sdram_bist_check(0, SDRAM_LEVELING_BIST_LENGTH);
+	sdram_dfii_control_write(DFII_CONTROL_SOFTWARE);
+
+	/* Precharge All (rows left open by the controller) */
+	sdram_dfii_pi0_address_write(1 << 10);
+	sdram_dfii_pi0_baddress_write(0);
+	command_p0(DFII_COMMAND_RAS|DFII_COMMAND_WE|DFII_COMMAND_CS);
+	cdelay(15);
+
+	/* Scale erroneous words to the DFII check range (used to compute the scan scores). */
+	errors = (errors*max_errors + SDRAM_LEVELING_BIST_LENGTH - 1)/SDRAM_LEVELING_BIST_LENGTH;
+
+#if defined(SDRAM_PHY_ECP5DDRPHY) || defined(SDRAM_PHY_GW2DDRPHY)
+	if ((((ddrphy_burstdet_seen_read() >> module) & 0x1) != 1) && (errors == 0))
+		errors = 1;
+#endif // defined(SDRAM_PHY_ECP5DDRPHY) || defined(SDRAM_PHY_GW2DDRPHY)
+
+	return errors;
+}
+#else
+static void sdram_leveling_module_ok(int module, int ok) {}
+#endif // SDRAM_LEVELING_BIST
+
+static void sdram_leveling_modules_reset(void) {
+#ifdef SDRAM_LEVELING_BIST
+	_sdram_leveling_modules_ok = 0;
+#endif // SDRAM_LEVELING_BIST
+}
+
 static int run_test_pattern(int module, int dq_line) {
 	int errors = 0;
+#ifdef SDRAM_LEVELING_BIST
+	if ((_sdram_leveling_modules_ok | (1u << module)) == (1u << SDRAM_PHY_MODULES) - 1)
+		return run_test_pattern_bist(module);
+#endif // SDRAM_LEVELING_BIST
 	for (int i = 0; i < _seed_array_length; i++) {
 		errors += sdram_write_read_check_test_pattern(module, _seed_array[i], dq_line);
 	}
@@ -435,10 +504,10 @@ static void sdram_leveling_center_module(
 
 	int i;
 	int show;
-	int working, last_working;
+	uint32_t working[(SDRAM_PHY_DELAYS + 31)/32];
 	unsigned int errors;
 	int delay, delay_mid, delay_range;
-	int delay_min = -1, delay_max = -1, cur_delay_min = -1;
+	int delay_min, delay_max;
 
 	if (show_long)
 #ifdef SDRAM_DELAY_PER_DQ
@@ -447,55 +516,23 @@ static void sdram_leveling_center_module(
 		printf("m%d: |", module);
 #endif // SDRAM_DELAY_PER_DQ
 
-	/* Find smallest working delay */
-	delay = 0;
-	working = 0;
+	/* Scan delays */
+	sdram_leveling_module_ok(module, 0);
+	memset(working, 0, sizeof(working));
 	sdram_leveling_action(module, dq_line, rst_delay);
-	while(1) {
+	for (delay = 0; delay < SDRAM_PHY_DELAYS; delay++) {
+		if (delay > 0)
+			sdram_leveling_action(module, dq_line, inc_delay);
 		errors = run_test_pattern(module, dq_line);
-		last_working = working;
-		working = errors == 0;
+		if (errors == 0)
+			working[delay/32] |= 1U << (delay%32);
 		show = show_long && (delay%MODULO == 0);
 		if (show)
 			print_scan_errors(errors);
-		if(working && last_working && delay_min < 0) {
-			delay_min = delay - 1; // delay on edges can be spotty
-			break;
-		}
-		delay++;
-		if(delay >= SDRAM_PHY_DELAYS)
-			break;
-		sdram_leveling_action(module, dq_line, inc_delay);
 	}
 
-	delay_max = delay_min;
-	cur_delay_min = delay_min;
 	/* Find largest working delay range */
-	while(1) {
-		errors = run_test_pattern(module, dq_line);
-		working = errors == 0;
-		show = show_long && (delay%MODULO == 0);
-		if (show)
-			print_scan_errors(errors);
-
-		if (working) {
-			int cur_delay_length = delay - cur_delay_min;
-			int best_delay_length = delay_max - delay_min;
-			if (cur_delay_length > best_delay_length) {
-				delay_min = cur_delay_min;
-				delay_max = delay;
-			}
-		} else {
-			cur_delay_min = delay + 1;
-		}
-		delay++;
-		if(delay >= SDRAM_PHY_DELAYS)
-			break;
-		sdram_leveling_action(module, dq_line, inc_delay);
-	}
-	if(delay_max < 0) {
-		delay_max = delay;
-	}
+	sdram_leveling_find_window(working, SDRAM_PHY_DELAYS, &delay_min, &delay_max);
 
 	if (show_long)
 		printf("| ");
@@ -530,6 +567,7 @@ static void sdram_leveling_center_module(
 				break;
 			retries--;
 		}
+		sdram_leveling_module_ok(module, errors == 0);
 	}
 }
 
@@ -802,6 +840,7 @@ int sdram_write_leveling(void) {
 	int cdly_range_end;
 	int cdly_range_step;
 
+	sdram_leveling_modules_reset();
 	_sdram_tck_taps = ddrphy_half_sys8x_taps_read()*4;
 	printf("  tCK equivalent taps: %d\n", _sdram_tck_taps);
 
@@ -881,6 +920,7 @@ static unsigned int sdram_read_leveling_scan_module(int module, int bitslip, int
 	score = 0;
 	if (show)
 		printf("  m%d, b%02d: |", module, bitslip);
+	sdram_leveling_module_ok(module, 0);
 	sdram_leveling_action(module, dq_line, read_rst_dq_delay);
 	for(i=0;i<SDRAM_PHY_DELAYS;i++) {
 		int working;
@@ -1104,6 +1144,9 @@ int sdram_leveling(void) {
 	int module;
 	int dq_line;
 	sdram_software_control_on();
+#ifdef CSR_DDRPHY_BASE
+	sdram_leveling_modules_reset();
+#endif // CSR_DDRPHY_BASE
 
 	for(module=0; module<SDRAM_PHY_MODULES; module++) {
 		for (dq_line = 0; dq_line < DQ_COUNT; dq_line++) {
@@ -1175,6 +1218,7 @@ int sdram_init(void) {
 	_sdram_write_leveling_cmd_delay = SDRAM_PHY_CMD_DELAY;
 #endif // SDRAM_PHY_CMD_DELAY
 	printf("Initializing SDRAM @0x%08lx...\n", MAIN_RAM_BASE);
+	trace_point("sdram_init");
 	sdram_software_control_on();
 #if CSR_DDRPHY_RST_ADDR
 	ddrphy_rst_write(1);
@@ -1189,10 +1233,14 @@ int sdram_init(void) {
 #endif // CSR_DDRCTRL_BASE
 	init_sequence();
 #if defined(SDRAM_PHY_WRITE_LEVELING_CAPABLE) || defined(SDRAM_PHY_READ_LEVELING_CAPABLE)
+	init_tasks_poll();
+	trace_point("sdram_leveling");
 	sdram_leveling();
 #endif // defined(SDRAM_PHY_WRITE_LEVELING_CAPABLE) || defined(SDRAM_PHY_READ_LEVELING_CAPABLE)
 	sdram_software_control_off();
 #ifndef SDRAM_TEST_DISABLE
+	init_tasks_poll();
+	trace_point("sdram_memtest");
 	if(!memtest((unsigned int *) MAIN_RAM_BASE, MEMTEST_DATA_SIZE)) {
 #ifdef CSR_DDRCTRL_BASE
 		ddrctrl_init_error_write(1);
@@ -1200,6 +1248,8 @@ int sdram_init(void) {
 #endif // CSR_DDRCTRL_BASE
 		return 0;
 	}
+	init_tasks_poll();
+	trace_point("sdram_memspeed");
 	memspeed((unsigned int *) MAIN_RAM_BASE, MEMTEST_DATA_SIZE, false, 0);
 #endif // SDRAM_TEST_DISABLE
 #ifdef CSR_DDRCTRL_BASE
@@ -2,6 +2,7 @@
 // License: BSD
 
 #include <stdio.h>
+#include <inttypes.h>
 
 #include <liblitedram/utils.h>
 #include <liblitedram/sdram_spd.h>
@@ -30,6 +31,42 @@ void print_progress(const char * header, uint64_t origin, uint64_t size)
 	printf("   \r");
 }
 
+#define LEVELING_WORKING(d) ((working[(d)/32] >> ((d)%32)) & 1)
+
+int sdram_leveling_find_window(const uint32_t *working, int ndelays, int *delay_min, int *delay_max)
+{
+	int delay;
+	int cur_delay_min;
+
+	*delay_min = -1;
+	*delay_max = -1;
+
+	/* Find smallest working delay */
+	for (delay = 1; delay < ndelays; delay++) {
+		if (LEVELING_WORKING(delay) && LEVELING_WORKING(delay - 1)) {
+			*delay_min = delay - 1; // delay on edges can be spotty
+			break;
+		}
+	}
+	if (*delay_min < 0)
+		return 0;
+
+	/* Find largest working delay range */
+	*delay_max    = *delay_min;
+	cur_delay_min = *delay_min;
+	for (; delay < ndelays; delay++) {
+		if (LEVELING_WORKING(delay)) {
+			if (delay - cur_delay_min > *delay_max - *delay_min) {
+				*delay_min = cur_delay_min;
+				*delay_max = delay;
+			}
+		} else {
+			cur_delay_min = delay + 1;
+		}
+	}
+	return 1;
+}
+
 #ifdef CSR_SDRAM_BASE
 
 #include <generated/sdram_phy.h>
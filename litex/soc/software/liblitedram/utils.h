@@ -13,6 +13,10 @@ extern "C" {
 void print_size(uint64_t size);
 void print_progress(const char * header, uint64_t origin, uint64_t size);
 
+/* Find the largest window of consecutive working delays of a leveling scan (bit d of working[]
+ * set when delay d passes). Returns 0 (and -1 delays) when no window is found. */
+int sdram_leveling_find_window(const uint32_t *working, int ndelays, int *delay_min, int *delay_max);
+
 uint64_t sdram_get_supported_memory(void);
 
 #ifdef __cplusplus
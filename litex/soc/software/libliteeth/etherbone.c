@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: BSD-Source-Code
+
+#include <generated/csr.h>
+
+#ifdef CSR_ETHMAC_BASE
+
+#include <stdint.h>
+#include <string.h>
+
+#include <libliteeth/udp.h>
+#include <libliteeth/etherbone.h>
+
+/* Etherbone packet: 8-byte header (magic, version/flags, address/port sizes) followed by records:
+ * 4-byte header (flags, byte enable, write count, read count), then for writes the base write
+ * address and the datas, then for reads the base return address and the read addresses (all
+ * 32-bit, big endian). Reads are answered with write records (to the base return address), all
+ * the answers of a packet being batched in a single reply.
+ */
+
+#define ETHERBONE_MAGIC        0x4e6f
+#define ETHERBONE_VERSION      1
+#define ETHERBONE_HEADER_LEN   8
+#define ETHERBONE_RECORD_LEN   4
+
+#define ETHERBONE_PF           0x01 /* Probe flag */
+#define ETHERBONE_PR           0x02 /* Probe reply */
+#define ETHERBONE_NR           0x04 /* No reads */
+
+#define ETHERBONE_RECORD_WFF   0x40 /* Write FIFO (no address increment) */
+
+static unsigned short etherbone_port;
+static struct etherbone_stats etherbone_stats;
+
+static inline uint32_t get_be32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline void put_be32(uint8_t *p, uint32_t v)
+{
+	p[0] = v >> 24;
+	p[1] = v >> 16;
+	p[2] = v >>  8;
+	p[3] = v;
+}
+
+static void etherbone_rx_callback(uint32_t src_ip, uint16_t src_port, uint16_t dst_port, void *_data, unsigned int length)
+{
+	const uint8_t *rx = _data;
+	const uint8_t *end = rx + length;
+	uint8_t *tx;
+	unsigned int txlen;
+	unsigned int wcount, rcount, i;
+	uint32_t addr;
+	volatile uint32_t *p;
+
+	if (dst_port != etherbone_port)
+		return;
+	if ((length < ETHERBONE_HEADER_LEN) ||
+		(((rx[0] << 8) | rx[1]) != ETHERBONE_MAGIC) ||
+		((rx[2] >> 4) != ETHERBONE_VERSION) ||
+		(rx[3] != 0x44)) { /* 32-bit addresses and ports */
+		etherbone_stats.errors++;
+		return;
+	}
+	etherbone_stats.packets++;
+
+	/* Reply header (same addr/port sizes) */
+	tx = udp_get_tx_buffer();
+	memcpy(tx, rx, ETHERBONE_HEADER_LEN);
+	tx[2] = ETHERBONE_VERSION << 4;
+	txlen = ETHERBONE_HEADER_LEN;
+
+	/* Probe: reply with the probe reply flag */
+	if (rx[2] & ETHERBONE_PF) {
+		etherbone_stats.probes++;
+		tx[2] |= ETHERBONE_PR;
+		memset(tx + txlen, 0, 4); /* Padding */
+		udp_reply(etherbone_port, src_port, txlen + 4);
+		return;
+	}
+
+	/* Records */
+	rx += ETHERBONE_HEADER_LEN;
+	while (rx + ETHERBONE_RECORD_LEN <= end) {
+		const uint8_t *record = rx;
+
+		wcount = record[2];
+		rcount = record[3];
+		rx += ETHERBONE_RECORD_LEN;
+		if ((wcount == 0) && (rcount == 0))
+			continue; /* Padding */
+		if (rx + (wcount ? 4*(wcount + 1) : 0) + (rcount ? 4*(rcount + 1) : 0) > end) {
+			etherbone_stats.errors++;
+			break;
+		}
+		etherbone_stats.records++;
+
+		/* Writes */
+		if (wcount) {
+			addr = get_be32(rx);
+			rx += 4;
+			for (i = 0; i < wcount; i++) {
+				p = (volatile uint32_t *)(uintptr_t) addr;
+				*p = get_be32(rx);
+				rx += 4;
+				if (!(record[0] & ETHERBONE_RECORD_WFF))
+					addr += 4;
+			}
+			etherbone_stats.writes += wcount;
+		}
+
+		/* Reads, answered by a write record to the base return address */
+		if (rcount) {
+			tx[txlen + 0] = 0;
+			tx[txlen + 1] = record[1];
+			tx[txlen + 2] = rcount;
+			tx[txlen + 3] = 0;
+			memcpy(tx + txlen + 4, rx, 4); /* Base return address */
+			txlen += 8;
+			rx += 4;
+			for (i = 0; i < rcount; i++) {
+				p = (volatile uint32_t *)(uintptr_t) get_be32(rx);
+				put_be32(tx + txlen, *p);
+				rx += 4;
+				txlen += 4;
+			}
+			etherbone_stats.reads += rcount;
+		}
+	}
+
+	if (txlen > ETHERBONE_HEADER_LEN)
+		udp_reply(etherbone_port, src_port, txlen);
+}
+
+void etherbone_start(unsigned short port)
+{
+	etherbone_port = port;
+	memset(&etherbone_stats, 0, sizeof(etherbone_stats));
+	udp_set_callback((udp_callback) etherbone_rx_callback);
+}
+
+void etherbone_stop(void)
+{
+	udp_set_callback(NULL);
+}
+
+const struct etherbone_stats *etherbone_get_stats(void)
+{
+	return &etherbone_stats;
+}
+
+#endif
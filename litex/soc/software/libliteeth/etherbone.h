@@ -0,0 +1,30 @@
+#ifndef __ETHERBONE_H
+#define __ETHERBONE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Etherbone (UDP) server over the LiteEth MAC: memory reads/writes executed by the CPU, for SoCs
+   without hardware Etherbone (litex_server --udp, litex_client). */
+
+#define ETHERBONE_PORT 1234
+
+struct etherbone_stats {
+	unsigned int packets; /* Etherbone packets received */
+	unsigned int probes;
+	unsigned int records;
+	unsigned int reads;   /* 32-bit words */
+	unsigned int writes;  /* 32-bit words */
+	unsigned int errors;  /* Malformed/unsupported packets */
+};
+
+void etherbone_start(unsigned short port);
+void etherbone_stop(void);
+const struct etherbone_stats *etherbone_get_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ETHERBONE_H */
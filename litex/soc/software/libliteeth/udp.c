@@ -16,6 +16,7 @@
 #include <system.h>
 
 #include <libbase/crc.h>
+#include <libbase/init_task.h>
 
 #include <libliteeth/inet.h>
 #include <libliteeth/udp.h>
@@ -315,20 +316,17 @@ struct pseudo_header {
 	unsigned short length;
 } __attribute__((packed));
 
-int udp_send(unsigned short src_port, unsigned short dst_port, unsigned int length)
+static void udp_send_to(const unsigned char *dst_mac, unsigned int dst_ip,
+	unsigned short src_port, unsigned short dst_port, unsigned int length)
 {
 	struct pseudo_header h;
 	unsigned int r;
 
-	if((cached_mac[0] == 0) && (cached_mac[1] == 0) && (cached_mac[2] == 0)
-		&& (cached_mac[3] == 0) && (cached_mac[4] == 0) && (cached_mac[5] == 0))
-		return 0;
-
 	txlen = length + sizeof(struct ethernet_header) + sizeof(struct udp_frame);
 	if(txlen < ARP_PACKET_LENGTH) txlen = ARP_PACKET_LENGTH;
 
 	fill_eth_header(&txbuffer->frame.eth_header,
-		cached_mac,
+		dst_mac,
 		my_mac,
 		ETHERTYPE_IP);
 
@@ -341,7 +339,7 @@ int udp_send(unsigned short src_port, unsigned short dst_port, unsigned int leng
 	h.proto = txbuffer->frame.contents.udp.ip.proto = IP_PROTO_UDP;
 	txbuffer->frame.contents.udp.ip.checksum = 0;
 	h.src_ip = txbuffer->frame.contents.udp.ip.src_ip = htonl(my_ip);
-	h.dst_ip = txbuffer->frame.contents.udp.ip.dst_ip = htonl(cached_ip);
+	h.dst_ip = txbuffer->frame.contents.udp.ip.dst_ip = htonl(dst_ip);
 	txbuffer->frame.contents.udp.ip.checksum = htons(ip_checksum(0, &txbuffer->frame.contents.udp.ip,
 		sizeof(struct ip_header), 1));
 
@@ -361,6 +359,29 @@ int udp_send(unsigned short src_port, unsigned short dst_port, unsigned int leng
 	txbuffer->frame.contents.udp.udp.checksum = htons(r);
 
 	send_packet();
+}
+
+int udp_send(unsigned short src_port, unsigned short dst_port, unsigned int length)
+{
+	if((cached_mac[0] == 0) && (cached_mac[1] == 0) && (cached_mac[2] == 0)
+		&& (cached_mac[3] == 0) && (cached_mac[4] == 0) && (cached_mac[5] == 0))
+		return 0;
+
+	udp_send_to(cached_mac, cached_ip, src_port, dst_port, length);
+
+	return 1;
+}
+
+/* Sender of the frame being processed (for udp_reply from the rx callback). */
+static unsigned char reply_mac[6];
+static unsigned int reply_ip;
+
+int udp_reply(unsigned short src_port, unsigned short dst_port, unsigned int length)
+{
+	if(reply_ip == 0)
+		return 0;
+
+	udp_send_to(reply_mac, reply_ip, src_port, dst_port, length);
 
 	return 1;
 }
@@ -382,9 +403,15 @@ static void process_ip(void)
 	if(ntohl(udp_ip->ip.dst_ip) != my_ip) return;
 	if(ntohs(udp_ip->udp.length) < sizeof(struct udp_header)) return;
 
-	if(rx_callback)
+	if(rx_callback) {
+		int i;
+		for(i=0;i<6;i++)
+			reply_mac[i] = rxbuffer->frame.eth_header.srcmac[i];
+		reply_ip = ntohl(udp_ip->ip.src_ip);
 		rx_callback(ntohl(udp_ip->ip.src_ip), ntohs(udp_ip->udp.src_port), ntohs(udp_ip->udp.dst_port),
 			    udp_ip->payload, ntohs(udp_ip->udp.length)-sizeof(struct udp_header));
+		reply_ip = 0;
+	}
 }
 
 void udp_set_callback(udp_callback callback)
@@ -461,17 +488,36 @@ void udp_service(void)
 	}
 }
 
-void eth_init(void)
+/* Ethernet PHY init as an init task step: PHY reset asserted for 200ms then 200ms to settle. */
+int eth_init_step(struct init_task *task)
 {
-	printf("Ethernet init...\n");
+	switch (task->state) {
+	case 0:
+		printf("Ethernet init...\n");
 #ifdef CSR_ETHPHY_CRG_RESET_ADDR
 #ifndef ETH_PHY_NO_RESET
-	ethphy_crg_reset_write(1);
-	busy_wait(200);
-	ethphy_crg_reset_write(0);
-	busy_wait(200);
+		ethphy_crg_reset_write(1);
+		init_task_sleep(task, 200);
+		task->state = 1;
+		return INIT_TASK_PENDING;
+	case 1:
+		ethphy_crg_reset_write(0);
+		init_task_sleep(task, 200);
+		task->state = 2;
+		return INIT_TASK_PENDING;
 #endif
 #endif
+	default:
+		task->result = 1;
+		return INIT_TASK_DONE;
+	}
+}
+
+void eth_init(void)
+{
+	struct init_task task = INIT_TASK("eth", eth_init_step);
+
+	init_task_run(&task);
 }
 
 #ifdef CSR_ETHPHY_MODE_DETECTION_MODE_ADDR
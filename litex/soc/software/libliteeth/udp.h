@@ -5,6 +5,8 @@
 extern "C" {
 #endif
 
+#include <libbase/init_task.h>
+
 #define ETHMAC_EV_SRAM_WRITER	0x1
 #define ETHMAC_EV_SRAM_READER	0x1
 
@@ -20,9 +22,11 @@ void udp_start(const unsigned char *macaddr, unsigned int ip);
 int udp_arp_resolve(unsigned int ip);
 void *udp_get_tx_buffer(void);
 int udp_send(unsigned short src_port, unsigned short dst_port, unsigned int length);
+int udp_reply(unsigned short src_port, unsigned short dst_port, unsigned int length);
 void udp_set_callback(udp_callback callback);
 void udp_service(void);
 
+int eth_init_step(struct init_task *task);
 void eth_init(void);
 void eth_mode(void);
 
@@ -9,6 +9,7 @@
 #include <generated/mem.h>
 #include <system.h>
 
+#include <libbase/init_task.h>
 #include <libfatfs/ff.h>
 #include <libfatfs/diskio.h>
 #include "sata.h"
@@ -19,124 +20,292 @@
 
 #ifdef CSR_SATA_PHY_BASE
 
-int sata_init(int show) {
-	uint16_t timeout;
+#define SATA_INIT_RETRIES 16
+
+static DSTATUS satastatus = STA_NOINIT;
+
+static uint8_t  sata_model[38];
+static unsigned sata_capacity;
+
+enum {
+	SATA_INIT_PHY_RESET,
+	SATA_INIT_PHY_ENABLE,
+	SATA_INIT_PHY_STATUS,
+	SATA_INIT_IDENTIFY,
+};
+
+static void sata_identify(void) {
 	int i;
 	uint32_t data;
 	uint16_t buf[128];
-	uint8_t  model[38];
 	uint64_t sectors;
-	unsigned capacity;
 
-	for (timeout=16; timeout>0; timeout--) {
+	/* Dump Idenfify response to buf */
+	i = 0;
+	while (sata_identify_source_valid_read() && (i < 128)) {
+		data = sata_identify_source_data_read();
+		sata_identify_source_ready_write(1);
+		buf[i+0] = ((data >>  0) & 0xffff);
+		buf[i+1] = ((data >> 16) & 0xffff);
+		i += 2;
+	}
+
+	/* Get Disk Model from buf */
+	i = 0;
+	memset(sata_model, 0, 38);
+	for (i=0; i<18; i++) {
+		sata_model[2*i + 0] = (buf[27+i] >> 8) & 0xff;
+		sata_model[2*i + 1] = (buf[27+i] >> 0) & 0xff;
+	}
+
+	/* Get Disk Capacity from buf */
+	sectors = 0;
+	sectors += (((uint64_t) buf[100]) <<  0);
+	sectors += (((uint64_t) buf[101]) << 16);
+	sectors += (((uint64_t) buf[102]) << 32);
+	sectors += (((uint64_t) buf[103]) << 48);
+	sata_capacity = sectors/(1000*1000*500/256);
+}
+
+/* SATA init as an init task step: the PHY reset/link-up and Identify waits are returned to the
+   scheduler instead of busy waiting. */
+int sata_init_step(struct init_task *task) {
+	switch (task->state) {
+	case SATA_INIT_PHY_RESET:
+		if (task->retries++ >= SATA_INIT_RETRIES)
+			break;
 		/* Reset SATA PHY */
 		sata_phy_enable_write(0);
-		busy_wait(1);
+		init_task_sleep(task, 1);
+		task->state = SATA_INIT_PHY_ENABLE;
+		return INIT_TASK_PENDING;
+
+	case SATA_INIT_PHY_ENABLE:
 		sata_phy_enable_write(1);
 
 		/* Wait for 100ms */
-		busy_wait(100);
+		init_task_sleep(task, 100);
+		task->state = SATA_INIT_PHY_STATUS;
+		return INIT_TASK_PENDING;
 
-		/* Check SATA PHY status */
+	case SATA_INIT_PHY_STATUS:
+		/* Check SATA PHY status, re-initialize if failing */
+		task->state = SATA_INIT_PHY_RESET;
 		if ((sata_phy_status_read() & 0x1) == 0)
-			/* Re-initialize if failing */
-			continue;
+			return INIT_TASK_PENDING;
 
 		/* Initiate a SATA Identify */
 		sata_identify_start_write(1);
 
 		/* Wait for 100ms */
-		busy_wait(100);
+		init_task_sleep(task, 100);
+		task->state = SATA_INIT_IDENTIFY;
+		return INIT_TASK_PENDING;
 
-		/* Check SATA Identify status */
+	case SATA_INIT_IDENTIFY:
+		/* Check SATA Identify status, re-initialize if failing */
+		task->state = SATA_INIT_PHY_RESET;
 		if ((sata_identify_done_read() & 0x1) == 0)
-			/* Re-initialize if failing */
-			continue;
-
-		if (show)
-			printf("\n");
-
-		/* Dump Idenfify response to buf */
-		i = 0;
-		while (sata_identify_source_valid_read() && (i < 128)) {
-			data = sata_identify_source_data_read();
-			sata_identify_source_ready_write(1);
-			buf[i+0] = ((data >>  0) & 0xffff);
-			buf[i+1] = ((data >> 16) & 0xffff);
-			i += 2;
-		}
-
-		/* Get Disk Model from buf */
-		i = 0;
-		memset(model, 0, 38);
-		for (i=0; i<18; i++) {
-			model[2*i + 0] = (buf[27+i] >> 8) & 0xff;
-			model[2*i + 1] = (buf[27+i] >> 0) & 0xff;
-		}
-		if (show)
-			printf("Model:    %s\n", model);
-
-		/* Get Disk Capacity from buf */
-		sectors = 0;
-		sectors += (((uint64_t) buf[100]) <<  0);
-		sectors += (((uint64_t) buf[101]) << 16);
-		sectors += (((uint64_t) buf[102]) << 32);
-		sectors += (((uint64_t) buf[103]) << 48);
-		capacity = sectors/(1000*1000*500/256);
-		if (show)
-			printf("Capacity: %dGB\n", capacity);
+			return INIT_TASK_PENDING;
+
+		sata_identify();
 
 		/* Init succeeded */
-		return 1;
+		task->result = 1;
+		break;
+	}
+
+	satastatus = task->result ? 0 : STA_NOINIT;
+	return INIT_TASK_DONE;
+}
+
+int sata_init(int show) {
+	struct init_task task = INIT_TASK("sata", sata_init_step);
+
+	if (!init_task_run(&task))
+		return 0;
+
+	if (show) {
+		printf("\n");
+		printf("Model:    %s\n", sata_model);
+		printf("Capacity: %dGB\n", sata_capacity);
 	}
+	return 1;
+}
+
+#endif
+
+#if defined(CSR_SATA_SECTOR2MEM_BASE) || defined(CSR_SATA_MEM2SECTOR_BASE)
+
+/* Transfers are retried up to SATA_MAX_RETRIES times on error/timeout, with an exponential
+   backoff starting at SATA_RETRY_BACKOFF_US. */
+#ifndef SATA_MAX_RETRIES
+#define SATA_MAX_RETRIES 8
+#endif
+
+#ifndef SATA_RETRY_BACKOFF_US
+#define SATA_RETRY_BACKOFF_US 10
+#endif
+
+#ifndef SATA_DONE_TIMEOUT
+#define SATA_DONE_TIMEOUT 0x00ffffff
+#endif
 
-	/* Init failed */
-	return 0;
+struct sata_xfer {
+	uint32_t sector;
+	uint32_t count;
+	uint8_t *buf;
+	uint32_t polls;
+	uint8_t  retries;
+	uint8_t  pending;
+};
+
+static int sata_xfer_retry(struct sata_xfer *xfer, void (*start)(struct sata_xfer *xfer))
+{
+	if (xfer->retries >= SATA_MAX_RETRIES) {
+		xfer->pending = 0;
+		return SATA_XFER_ERROR;
+	}
+	busy_wait_us(SATA_RETRY_BACKOFF_US << xfer->retries);
+	xfer->retries++;
+	start(xfer);
+	return SATA_XFER_BUSY;
 }
 
 #endif
 
 #ifdef CSR_SATA_SECTOR2MEM_BASE
 
-void sata_read(uint32_t sector, uint32_t count, uint8_t* buf)
+static struct sata_xfer sata_rd_xfer;
+
+static void sata_read_start(struct sata_xfer *xfer)
 {
-	uint8_t done = 0;
-
-	while (done == 0) {
-		sata_sector2mem_base_write((uint64_t)(uintptr_t) buf);
-		sata_sector2mem_sector_write(sector);
-		sata_sector2mem_nsectors_write(count);
-		sata_sector2mem_start_write(1);
-		while ((sata_sector2mem_done_read() & 0x1) == 0);
-		done = ((sata_sector2mem_error_read() & 0x1) == 0);
-		busy_wait_us(10);
+	sata_sector2mem_base_write((uint64_t)(uintptr_t) xfer->buf);
+	sata_sector2mem_sector_write(xfer->sector);
+	sata_sector2mem_nsectors_write(xfer->count);
+	sata_sector2mem_start_write(1);
+	xfer->polls = 0;
+}
+
+int sata_read_submit(uint32_t sector, uint32_t count, uint8_t* buf)
+{
+	/* Only one read can be in flight: complete the previous one first. */
+	if (sata_rd_xfer.pending && (sata_read_wait() != SATA_XFER_DONE))
+		return SATA_XFER_ERROR;
+
+	sata_rd_xfer.sector  = sector;
+	sata_rd_xfer.count   = count;
+	sata_rd_xfer.buf     = buf;
+	sata_rd_xfer.retries = 0;
+	sata_rd_xfer.pending = 1;
+	sata_read_start(&sata_rd_xfer);
+	return SATA_XFER_BUSY;
+}
+
+int sata_read_poll(void)
+{
+	if (!sata_rd_xfer.pending)
+		return SATA_XFER_DONE;
+
+	if ((sata_sector2mem_done_read() & 0x1) == 0) {
+		if (++sata_rd_xfer.polls < SATA_DONE_TIMEOUT)
+			return SATA_XFER_BUSY;
+		return sata_xfer_retry(&sata_rd_xfer, sata_read_start);
 	}
+	if (sata_sector2mem_error_read() & 0x1)
+		return sata_xfer_retry(&sata_rd_xfer, sata_read_start);
 
+	sata_rd_xfer.pending = 0;
 #ifndef CONFIG_CPU_HAS_DMA_BUS
 	/* Flush caches */
 	flush_cpu_dcache();
 	flush_l2_cache();
 #endif
+	return SATA_XFER_DONE;
+}
+
+int sata_read_wait(void)
+{
+	int ret;
+	do {
+		ret = sata_read_poll();
+	} while (ret == SATA_XFER_BUSY);
+	return ret;
+}
+
+int sata_read(uint32_t sector, uint32_t count, uint8_t* buf)
+{
+	if (sata_read_submit(sector, count, buf) == SATA_XFER_ERROR)
+		return SATA_XFER_ERROR;
+	return sata_read_wait();
 }
 
 #endif
 
 #ifdef CSR_SATA_MEM2SECTOR_BASE
 
-void sata_write(uint32_t sector, uint32_t count, uint8_t* buf)
+static struct sata_xfer sata_wr_xfer;
+
+static void sata_write_start(struct sata_xfer *xfer)
+{
+	sata_mem2sector_base_write((uint64_t)(uintptr_t) xfer->buf);
+	sata_mem2sector_sector_write(xfer->sector);
+	sata_mem2sector_nsectors_write(xfer->count);
+	sata_mem2sector_start_write(1);
+	xfer->polls = 0;
+}
+
+int sata_write_submit(uint32_t sector, uint32_t count, uint8_t* buf)
 {
-	uint8_t done = 0;
-
-	/* Write sectors */
-	while (done == 0) {
-		sata_mem2sector_base_write((uint64_t)(uintptr_t) buf);
-		sata_mem2sector_sector_write(sector);
-		sata_mem2sector_nsectors_write(count);
-		sata_mem2sector_start_write(1);
-		while ((sata_mem2sector_done_read() & 0x1) == 0);
-		done = ((sata_mem2sector_error_read() & 0x1) == 0);
-		busy_wait_us(10);
+	/* Only one write can be in flight: complete the previous one first. */
+	if (sata_wr_xfer.pending && (sata_write_wait() != SATA_XFER_DONE))
+		return SATA_XFER_ERROR;
+
+#ifndef CONFIG_CPU_HAS_DMA_BUS
+	/* Make sure the DMA sees the CPU's writes to buf */
+	flush_cpu_dcache();
+	flush_l2_cache();
+#endif
+	sata_wr_xfer.sector  = sector;
+	sata_wr_xfer.count   = count;
+	sata_wr_xfer.buf     = buf;
+	sata_wr_xfer.retries = 0;
+	sata_wr_xfer.pending = 1;
+	sata_write_start(&sata_wr_xfer);
+	return SATA_XFER_BUSY;
+}
+
+int sata_write_poll(void)
+{
+	if (!sata_wr_xfer.pending)
+		return SATA_XFER_DONE;
+
+	if ((sata_mem2sector_done_read() & 0x1) == 0) {
+		if (++sata_wr_xfer.polls < SATA_DONE_TIMEOUT)
+			return SATA_XFER_BUSY;
+		return sata_xfer_retry(&sata_wr_xfer, sata_write_start);
 	}
+	if (sata_mem2sector_error_read() & 0x1)
+		return sata_xfer_retry(&sata_wr_xfer, sata_write_start);
+
+	sata_wr_xfer.pending = 0;
+	return SATA_XFER_DONE;
+}
+
+int sata_write_wait(void)
+{
+	int ret;
+	do {
+		ret = sata_write_poll();
+	} while (ret == SATA_XFER_BUSY);
+	return ret;
+}
+
+int sata_write(uint32_t sector, uint32_t count, uint8_t* buf)
+{
+	if (sata_write_submit(sector, count, buf) == SATA_XFER_ERROR)
+		return SATA_XFER_ERROR;
+	return sata_write_wait();
 }
 
 #endif
@@ -147,8 +316,6 @@ void sata_write(uint32_t sector, uint32_t count, uint8_t* buf)
 
 #ifdef CSR_SATA_SECTOR2MEM_BASE
 
-static DSTATUS satastatus = STA_NOINIT;
-
 static DSTATUS sata_disk_status(BYTE drv) {
 	if (drv) return STA_NOINIT;
 	return satastatus;
@@ -162,7 +329,8 @@ static DSTATUS sata_disk_initialize(BYTE drv) {
 }
 
 static DRESULT sata_disk_read(BYTE drv, BYTE *buf, LBA_t sector, UINT count) {
-	sata_read(sector, count, buf);
+	if (sata_read(sector, count, buf) != SATA_XFER_DONE)
+		return RES_ERROR;
 	return RES_OK;
 }
 
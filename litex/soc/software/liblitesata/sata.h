@@ -9,6 +9,7 @@ extern "C" {
 #endif
 
 #include <generated/csr.h>
+#include <libbase/init_task.h>
 
 /*-----------------------------------------------------------------------*/
 /* SATA user functions                                                   */
@@ -16,20 +17,37 @@ extern "C" {
 
 #ifdef CSR_SATA_PHY_BASE
 
+int sata_init_step(struct init_task *task);
 int sata_init(int show);
 void fatfs_set_ops_sata(void);
 
 #endif
 
+/* Transfer status returned by the sata_read/sata_write functions. */
+#define SATA_XFER_DONE   0
+#define SATA_XFER_BUSY   1
+#define SATA_XFER_ERROR -1
+
+/* The *_submit functions start a transfer and return immediately (SATA_XFER_BUSY), letting the
+   CPU work on another buffer while the DMA runs; *_poll returns the status of the transfer in
+   flight (retrying it on error) and *_wait blocks until it completes. Submitting a new transfer
+   first completes the previous one. sata_read/sata_write are the blocking equivalents. */
+
 #ifdef CSR_SATA_SECTOR2MEM_BASE
 
-void sata_read(uint32_t sector, uint32_t count, uint8_t* buf);
+int sata_read_submit(uint32_t sector, uint32_t count, uint8_t* buf);
+int sata_read_poll(void);
+int sata_read_wait(void);
+int sata_read(uint32_t sector, uint32_t count, uint8_t* buf);
 
 #endif
 
 #ifdef CSR_SATA_MEM2SECTOR_BASE
 
-void sata_write(uint32_t sector, uint32_t count, uint8_t* buf);
+int sata_write_submit(uint32_t sector, uint32_t count, uint8_t* buf);
+int sata_write_poll(void);
+int sata_write_wait(void);
+int sata_write(uint32_t sector, uint32_t count, uint8_t* buf);
 
 #endif
 
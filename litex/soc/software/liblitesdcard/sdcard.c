@@ -14,6 +14,7 @@
 #include <generated/soc.h>
 #include <system.h>
 
+#include <libbase/init_task.h>
 #include <libfatfs/ff.h>
 #include <libfatfs/diskio.h>
 #include "sdcard.h"
@@ -375,49 +376,19 @@ void sdcard_decode_csd(void) {
 /* SDCard user functions                                                 */
 /*-----------------------------------------------------------------------*/
 
-int sdcard_init(void) {
-	uint16_t rca, timeout;
-	uint32_t r[SD_CMD_RESPONSE_SIZE/4];
-
-	/* Set SD clk freq to Initialization frequency */
-	sdcard_set_clk_freq(SDCARD_CLK_FREQ_INIT, 0);
-	busy_wait(1);
-
-	for (timeout=1000; timeout>0; timeout--) {
-		/* Set SDCard in SPI Mode (generate 80 dummy clocks) */
-		sdcard_phy_init_initialize_write(1);
-		busy_wait(1);
-
-		/* Set SDCard in Idle state */
-		if (sdcard_go_idle() == SD_OK)
-			break;
-		busy_wait(1);
-	}
-	if (timeout == 0)
-		return 0;
+#define SDCARD_INIT_TIMEOUT 1000 /* Idle/Operational state attempts, 1ms apart */
 
-	/* Set SDCard voltages, only supported by ver2.00+ SDCards */
-	if (sdcard_send_ext_csd() != SD_OK)
-		return 0;
-
-	/* Set SD clk freq to Operational frequency */
-	sdcard_set_clk_freq(SDCARD_CLK_FREQ, 0);
-	busy_wait(1);
+static DSTATUS sdcardstatus = STA_NOINIT;
 
-	/* Set SDCard in Operational state */
-	for (timeout=1000; timeout>0; timeout--) {
-		sdcard_app_cmd(0);
-		if (sdcard_app_send_op_cond(1) == SD_OK) {
-			csr_rd_buf_uint32(CSR_SDCARD_CORE_CMD_RESPONSE_ADDR,
-			  r, SD_CMD_RESPONSE_SIZE/4);
+enum {
+	SDCARD_INIT_START,
+	SDCARD_INIT_IDLE_CLOCKS,
+	SDCARD_INIT_IDLE,
+	SDCARD_INIT_OPERATIONAL,
+};
 
-			if (r[3] & 0x80000000) /* Busy bit, set when init is complete */
-				break;
-		}
-		busy_wait(1);
-	}
-	if (timeout == 0)
-		return 0;
+static int sdcard_init_card(void) {
+	uint16_t rca;
 
 	/* Send identification */
 	if (sdcard_all_send_cid() != SD_OK)
@@ -472,6 +443,75 @@ int sdcard_init(void) {
 	return 1;
 }
 
+/* SDCard init as an init task step: the 1ms waits between Idle/Operational state attempts are
+   returned to the scheduler instead of busy waiting. */
+int sdcard_init_step(struct init_task *task) {
+	uint32_t r[SD_CMD_RESPONSE_SIZE/4];
+
+	switch (task->state) {
+	case SDCARD_INIT_START:
+		/* Set SD clk freq to Initialization frequency */
+		sdcard_set_clk_freq(SDCARD_CLK_FREQ_INIT, 0);
+		init_task_sleep(task, 1);
+		task->state = SDCARD_INIT_IDLE_CLOCKS;
+		return INIT_TASK_PENDING;
+
+	case SDCARD_INIT_IDLE_CLOCKS:
+		/* Set SDCard in SPI Mode (generate 80 dummy clocks) */
+		sdcard_phy_init_initialize_write(1);
+		init_task_sleep(task, 1);
+		task->state = SDCARD_INIT_IDLE;
+		return INIT_TASK_PENDING;
+
+	case SDCARD_INIT_IDLE:
+		/* Set SDCard in Idle state */
+		if (sdcard_go_idle() != SD_OK) {
+			if (++task->retries >= SDCARD_INIT_TIMEOUT)
+				break;
+			init_task_sleep(task, 1);
+			task->state = SDCARD_INIT_IDLE_CLOCKS;
+			return INIT_TASK_PENDING;
+		}
+
+		/* Set SDCard voltages, only supported by ver2.00+ SDCards */
+		if (sdcard_send_ext_csd() != SD_OK)
+			break;
+
+		/* Set SD clk freq to Operational frequency */
+		sdcard_set_clk_freq(SDCARD_CLK_FREQ, 0);
+		init_task_sleep(task, 1);
+		task->retries = 0;
+		task->state   = SDCARD_INIT_OPERATIONAL;
+		return INIT_TASK_PENDING;
+
+	case SDCARD_INIT_OPERATIONAL:
+		/* Set SDCard in Operational state */
+		sdcard_app_cmd(0);
+		if (sdcard_app_send_op_cond(1) == SD_OK) {
+			csr_rd_buf_uint32(CSR_SDCARD_CORE_CMD_RESPONSE_ADDR,
+			  r, SD_CMD_RESPONSE_SIZE/4);
+
+			if (r[3] & 0x80000000) { /* Busy bit, set when init is complete */
+				task->result = sdcard_init_card();
+				break;
+			}
+		}
+		if (++task->retries >= SDCARD_INIT_TIMEOUT)
+			break;
+		init_task_sleep(task, 1);
+		return INIT_TASK_PENDING;
+	}
+
+	sdcardstatus = task->result ? 0 : STA_NOINIT;
+	return INIT_TASK_DONE;
+}
+
+int sdcard_init(void) {
+	struct init_task task = INIT_TASK("sdcard", sdcard_init_step);
+
+	return init_task_run(&task);
+}
+
 #ifdef CSR_SDCARD_BLOCK2MEM_BASE
 
 void sdcard_read(uint32_t block, uint32_t count, uint8_t* buf)
@@ -565,8 +605,6 @@ void sdcard_write(uint32_t block, uint32_t count, uint8_t* buf)
 /* SDCard FatFs disk functions                                           */
 /*-----------------------------------------------------------------------*/
 
-static DSTATUS sdcardstatus = STA_NOINIT;
-
 static DSTATUS sd_disk_status(BYTE drv) {
 	if (drv) return STA_NOINIT;
 	return sdcardstatus;
@@ -9,6 +9,7 @@ extern "C" {
 #endif
 
 #include <generated/csr.h>
+#include <libbase/init_task.h>
 
 #define CLKGEN_STATUS_BUSY		0x1
 #define CLKGEN_STATUS_PROGDONE	0x2
@@ -104,6 +105,7 @@ void sdcard_decode_csd(void);
 /* SDCard user functions                                                 */
 /*-----------------------------------------------------------------------*/
 
+int sdcard_init_step(struct init_task *task);
 int sdcard_init(void);
 void sdcard_read(uint32_t sector, uint32_t count, uint8_t* buf);
 void sdcard_write(uint32_t sector, uint32_t count, uint8_t* buf);
@@ -13,6 +13,7 @@
 #include <generated/soc.h>
 #include <system.h>
 
+#include <libbase/init_task.h>
 #include <libfatfs/ff.h>
 #include <libfatfs/diskio.h>
 #include "spisdcard.h"
@@ -207,59 +208,82 @@ static uint8_t spisdcardsend_cmd(uint8_t cmd, uint32_t arg)
 /* SPI SDCard Initialization functions                                   */
 /*-----------------------------------------------------------------------*/
 
-uint8_t spisdcard_init(void) {
+#define SPISDCARD_INIT_TIMEOUT 1000
+
+static DSTATUS spisdcardstatus = STA_NOINIT;
+
+enum {
+    SPISDCARD_INIT_IDLE,
+    SPISDCARD_INIT_OPERATIONAL,
+};
+
+/* SPI SDCard init as an init task step: the 1ms waits between Operational state attempts (up to
+   1s) are returned to the scheduler instead of busy waiting. */
+int spisdcard_init_step(struct init_task *task) {
     uint8_t  i;
     uint8_t  buf[4];
     uint16_t timeout;
 
-    /* Set SPI clk freq to initialization frequency */
-    spi_set_clk_freq(SPISDCARD_CLK_FREQ_INIT);
-
-    timeout = 1000;
-    while (timeout) {
-        /* Set SDCard in SPI Mode (generate 80 dummy clocks) */
-        spisdcard_cs_write(SPI_CS_HIGH);
-        for (i=0; i<10; i++)
-            spi_xfer(0xff);
-        spisdcard_cs_write(SPI_CS_LOW);
+    switch (task->state) {
+    case SPISDCARD_INIT_IDLE:
+        /* Set SPI clk freq to initialization frequency */
+        spi_set_clk_freq(SPISDCARD_CLK_FREQ_INIT);
+
+        timeout = SPISDCARD_INIT_TIMEOUT;
+        while (timeout) {
+            /* Set SDCard in SPI Mode (generate 80 dummy clocks) */
+            spisdcard_cs_write(SPI_CS_HIGH);
+            for (i=0; i<10; i++)
+                spi_xfer(0xff);
+            spisdcard_cs_write(SPI_CS_LOW);
+
+            /* Set SDCard in Idle state */
+            if (spisdcardsend_cmd(CMD0, 0) == 0x1)
+                break;
 
-        /* Set SDCard in Idle state */
-        if (spisdcardsend_cmd(CMD0, 0) == 0x1)
+            timeout--;
+        }
+        if (timeout == 0)
             break;
 
-        timeout--;
-    }
-    if (timeout == 0)
-        return 0;
+        /* Set SDCard voltages, only supported by ver2.00+ SDCards */
+        if (spisdcardsend_cmd(CMD8, 0x1AA) != 0x1)
+            break;
+        spisdcardread_bytes(buf, 4); /* Get additional bytes of R7 response */
+
+        task->state = SPISDCARD_INIT_OPERATIONAL;
+        /* Fall through */
+    case SPISDCARD_INIT_OPERATIONAL:
+        /* Set SDCard in Operational state (1s timeout) */
+        if (spisdcardsend_cmd(ACMD41, 1 << 30) != 0) {
+            if (++task->retries >= SPISDCARD_INIT_TIMEOUT)
+                break;
+            init_task_sleep(task, 1);
+            return INIT_TASK_PENDING;
+        }
 
-    /* Set SDCard voltages, only supported by ver2.00+ SDCards */
-    if (spisdcardsend_cmd(CMD8, 0x1AA) != 0x1)
-        return 0;
-    spisdcardread_bytes(buf, 4); /* Get additional bytes of R7 response */
+        /* Set SPI clk freq to operational frequency */
+        spi_set_clk_freq(SPISDCARD_CLK_FREQ);
 
-    /* Set SDCard in Operational state (1s timeout) */
-    timeout = 1000;
-    while (timeout > 0) {
-        if (spisdcardsend_cmd(ACMD41, 1 << 30) == 0)
-            break;
-        busy_wait(1);
-        timeout--;
+        task->result = 1;
+        break;
     }
-    if (timeout == 0)
-        return 0;
 
-    /* Set SPI clk freq to operational frequency */
-    spi_set_clk_freq(SPISDCARD_CLK_FREQ);
+    spisdcard_deselect();
+    spisdcardstatus = task->result ? 0 : STA_NOINIT;
+    return INIT_TASK_DONE;
+}
+
+uint8_t spisdcard_init(void) {
+    struct init_task task = INIT_TASK("spisdcard", spisdcard_init_step);
 
-    return 1;
+    return init_task_run(&task);
 }
 
 /*-----------------------------------------------------------------------*/
 /* SPI SDCard FatFs functions                                            */
 /*-----------------------------------------------------------------------*/
 
-static DSTATUS spisdcardstatus = STA_NOINIT;
-
 static DSTATUS spisd_disk_status(BYTE drv) {
     if (drv) return STA_NOINIT;
     return spisdcardstatus;
@@ -267,10 +291,8 @@ static DSTATUS spisd_disk_status(BYTE drv) {
 
 static DSTATUS spisd_disk_initialize(BYTE drv) {
     if (drv) return STA_NOINIT;
-    if (spisdcardstatus) {
-        spisdcardstatus = spisdcard_init() ? 0 : STA_NOINIT;
-        spisdcard_deselect();
-    }
+    if (spisdcardstatus)
+        spisdcard_init();
     return spisdcardstatus;
 }
 
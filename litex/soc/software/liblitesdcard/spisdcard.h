@@ -10,6 +10,7 @@ extern "C" {
 #endif
 
 #include <generated/csr.h>
+#include <libbase/init_task.h>
 
 #ifdef CSR_SPISDCARD_BASE
 
@@ -53,6 +54,7 @@ extern "C" {
 /* SPI SDCard User functions                                             */
 /*-----------------------------------------------------------------------*/
 
+int spisdcard_init_step(struct init_task *task);
 uint8_t spisdcard_init(void);
 void fatfs_set_ops_spisdcard(void);
 
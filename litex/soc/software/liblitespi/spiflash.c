@@ -7,6 +7,7 @@
 #include <string.h>
 #include <libbase/memtest.h>
 #include <libbase/crc.h>
+#include <libbase/trace.h>
 
 #include <generated/csr.h>
 #include <generated/mem.h>
@@ -162,7 +163,7 @@ static uint32_t spiflash_read_id_register(void)
 	return buf[3];
 }
 
-static uint32_t spiflash_read_status_register(void)
+uint32_t spiflash_read_status_register(void)
 {
 	volatile uint8_t buf[4];
 	w_buf[0] = 0x05;
@@ -196,81 +197,336 @@ static void page_program(uint32_t addr, uint8_t *data, int len)
 	transfer_cmd(w_buf, r_buf, len+4);
 }
 
-static void spiflash_sector_erase(uint32_t addr)
+/* Quad Page Program (0x32, 1-1-4): only for flashes supporting it (other quad program opcodes,
+   ex Macronix 0x38 4PP, are not compatible). */
+#ifdef SPIFLASH_MODULE_QUAD_PP_CAPABLE
+static void page_program_quad(uint32_t addr, uint8_t *data, int len)
 {
-	w_buf[0] = 0xd8;
+	int i;
+
+	/* Command/Address on 1 line. */
+	spiflash_len_mask_width_write(8, 1, 1);
+	spiflash_core_master_cs_write(1);
+	transfer_byte(0x32);
+	transfer_byte(addr>>16);
+	transfer_byte(addr>>8);
+	transfer_byte(addr>>0);
+
+	/* Data on 4 lines, 32-bit per Xfer (MSB first). */
+	spiflash_len_mask_width_write(32, 4, 0xf);
+	for (i=0; i<(len & ~3); i+=4) {
+		while (!spiflash_tx_ready());
+		spiflash_core_master_rxtx_write(
+			((uint32_t)data[i+0] << 24) |
+			((uint32_t)data[i+1] << 16) |
+			((uint32_t)data[i+2] <<  8) |
+			((uint32_t)data[i+3] <<  0));
+		while (!spiflash_rx_ready());
+		spiflash_core_master_rxtx_read();
+	}
+	spiflash_len_mask_width_write(8, 4, 0xf);
+	for (; i<len; i++)
+		transfer_byte(data[i]);
+
+	spiflash_core_master_cs_write(0);
+}
+#endif
+
+static void spiflash_erase(uint32_t addr, uint8_t opcode)
+{
+	w_buf[0] = opcode;
 	w_buf[1] = addr>>16;
 	w_buf[2] = addr>>8;
 	w_buf[3] = addr>>0;
 	transfer_cmd(w_buf, r_buf, 4);
 }
 
-/* erase page size in bytes, check flash datasheet */
-#define SPI_FLASH_ERASE_SIZE (64*1024)
+int spiflash_busy(void)
+{
+	return spiflash_read_status_register() & 1;
+}
+
+static void spiflash_wait_ready(void)
+{
+	while (spiflash_busy());
+}
 
 #define min(x, y) (((x) < (y)) ? (x) : (y))
+#define max(x, y) (((x) > (y)) ? (x) : (y))
+
+/* Erase opcodes/sizes, check flash datasheet */
+#define SPI_FLASH_ERASE_4K_OPCODE  0x20
+#define SPI_FLASH_ERASE_32K_OPCODE 0x52
+#define SPI_FLASH_ERASE_64K_OPCODE 0xd8
 
-void spiflash_erase_range(uint32_t addr, uint32_t len)
+void spiflash_erase_block_start(uint32_t addr, uint32_t size)
 {
-	uint32_t i = 0;
-	uint32_t j = 0;
-	for (i=0; i<len; i+=SPI_FLASH_ERASE_SIZE) {
-		printf("Erase SPI Flash @0x%08lx", ((uint32_t)addr+i));
-		spiflash_write_enable();
-		spiflash_sector_erase(addr+i);
-
-		while (spiflash_read_status_register() & 1) {
-			printf(".");
-			cdelay(CONFIG_CLOCK_FREQUENCY/25);
-		}
-		printf("\n");
+	uint8_t opcode;
+
+	switch (size) {
+	case 64*1024: opcode = SPI_FLASH_ERASE_64K_OPCODE; break;
+	case 32*1024: opcode = SPI_FLASH_ERASE_32K_OPCODE; break;
+	default:      opcode = SPI_FLASH_ERASE_4K_OPCODE;  break;
+	}
+	spiflash_write_enable();
+	spiflash_erase(addr, opcode);
+}
+
+static void spiflash_erase_block(uint32_t addr, uint32_t size)
+{
+	spiflash_erase_block_start(addr, size);
+	spiflash_wait_ready();
+}
+
+/* Largest erase block aligned on addr and fitting in len. */
+uint32_t spiflash_erase_block_size(uint32_t addr, uint32_t len)
+{
+	if (((addr % (64*1024)) == 0) && (len >= 64*1024))
+		return 64*1024;
+	if (((addr % (32*1024)) == 0) && (len >= 32*1024))
+		return 32*1024;
+	return SPI_FLASH_SECTOR_SIZE;
+}
+
+void spiflash_mmap_sync(void)
+{
+	flush_cpu_dcache();
+	flush_l2_cache();
+}
+
+static int spiflash_is_erased(uint32_t addr, uint32_t len)
+{
+	volatile uint32_t *p = (volatile uint32_t *)(SPIFLASH_BASE + addr);
+	uint32_t i;
+
+	for (i=0; i<len/4; i++)
+		if (p[i] != 0xffffffff)
+			return 0;
+	return 1;
+}
+
+int spiflash_erase_range(uint32_t addr, uint32_t len)
+{
+	uint32_t end = addr + len;
+	uint32_t size;
+	int ret = 0;
+
+	/* Only whole 4KB sectors can be erased: refuse to erase data outside of the range. */
+	if ((addr | len) & (SPI_FLASH_SECTOR_SIZE - 1)) {
+		printf("Error: 0x%08lx-0x%08lx not aligned on %dKB sectors\n",
+			addr, end - 1, SPI_FLASH_SECTOR_SIZE/1024);
+		return -1;
+	}
 
-		/* check if region was really erased */
-		for (j = 0; j < SPI_FLASH_ERASE_SIZE; j++) {
-			uint8_t* peek = (((uint8_t*)SPIFLASH_BASE)+addr+i+j);
-			if (*peek != 0xff) {
-				printf("Error: location 0x%08lx not erased (%0x2x)\n", addr+i+j, *peek);
+	/* Erase the sectors with the largest erase blocks possible. */
+	spiflash_mmap_sync();
+	while (addr < end) {
+		size = spiflash_erase_block_size(addr, end - addr);
+		if (!spiflash_is_erased(addr, size)) {
+			printf("Erase SPI Flash @0x%08lx (%ldKB)\n", addr, size/1024);
+			spiflash_erase_block(addr, size);
+			spiflash_mmap_sync();
+			/* check if region was really erased */
+			if (!spiflash_is_erased(addr, size)) {
+				printf("Error: 0x%08lx-0x%08lx not erased\n", addr, addr + size - 1);
+				ret = -1;
 			}
 		}
+		addr += size;
 	}
+	return ret;
 }
 
-int spiflash_write_stream(uint32_t addr, uint8_t *stream, uint32_t len)
+void spiflash_page_program_start(uint32_t addr, uint8_t *data, uint32_t len)
 {
-	int res = 0;
-	uint32_t w_len = min(len, SPI_FLASH_BLOCK_SIZE);
-	uint32_t offset = 0;
-	uint32_t j = 0;
-
-#ifdef SPIFLASH_DEBUG
-	printf("Write SPI Flash @0x%08lx", ((uint32_t)addr));
+	spiflash_write_enable();
+#ifdef SPIFLASH_MODULE_QUAD_PP_CAPABLE
+	page_program_quad(addr, data, len);
+#else
+	page_program(addr, data, len);
 #endif
+}
+
+static void spiflash_page_program(uint32_t addr, uint8_t *data, uint32_t len)
+{
+	spiflash_page_program_start(addr, data, len);
+	spiflash_wait_ready();
+}
+
+static int spiflash_verify(uint32_t addr, uint8_t *data, uint32_t len)
+{
+	spiflash_mmap_sync();
+	return crc32((unsigned char *)(SPIFLASH_BASE + addr), len) == crc32(data, len);
+}
 
-	while(w_len) {
-		spiflash_write_enable();
-		page_program(addr+offset, stream+offset, w_len);
+/* Programs data to (already erased) flash, page by page, skipping pages that are already equal to
+   the data (all 0xff pages on erased flash). */
+static void spiflash_program(uint32_t addr, uint8_t *data, uint32_t len)
+{
+	uint32_t w_len;
+
+	while (len) {
+		w_len = min(len, SPI_FLASH_BLOCK_SIZE - (addr % SPI_FLASH_BLOCK_SIZE));
+		if (memcmp((void *)(SPIFLASH_BASE + addr), data, w_len) != 0)
+			spiflash_page_program(addr, data, w_len);
+		addr += w_len;
+		data += w_len;
+		len  -= w_len;
+	}
+}
 
-		while(spiflash_read_status_register() & 1) {
+int spiflash_write_stream(uint32_t addr, uint8_t *stream, uint32_t len)
+{
 #ifdef SPIFLASH_DEBUG
-			printf(".");
+	printf("Write SPI Flash @0x%08lx\n", ((uint32_t)addr));
 #endif
+
+	spiflash_mmap_sync();
+	spiflash_program(addr, stream, len);
+	if (!spiflash_verify(addr, stream, len)) {
+		printf("Error: verify failed at 0x%08lx-0x%08lx\n", addr, addr + len - 1);
+		return -1;
+	}
+	return len;
+}
+
+int spiflash_sector_state(uint32_t addr, uint8_t *data, uint32_t len)
+{
+	uint8_t *flash = (uint8_t *)(SPIFLASH_BASE + addr);
+	uint32_t i;
+	int state = SPIFLASH_SECTOR_SAME;
+
+	for (i=0; i<len; i++) {
+		if (flash[i] == data[i])
+			continue;
+		if ((flash[i] & data[i]) != data[i])
+			return SPIFLASH_SECTOR_ERASE;
+		state = SPIFLASH_SECTOR_PROGRAM;
+	}
+	return state;
+}
+
+/* Returns 1 when verified, 0 on verify error, -1 when the sector can't be erased without losing
+   data outside of the range (no read-modify-write buffer). */
+static int spiflash_write_sector(uint32_t sector, uint32_t addr, uint8_t *data, uint32_t len, int erased,
+	uint8_t *rmw_buf)
+{
+	uint32_t lo = max(addr, sector);
+	uint32_t hi = min(addr + len, sector + SPI_FLASH_SECTOR_SIZE);
+	uint8_t *sdata = data + (lo - addr);
+
+	if (!erased) {
+		if ((hi - lo) == SPI_FLASH_SECTOR_SIZE) {
+			spiflash_erase_block(sector, SPI_FLASH_SECTOR_SIZE);
+		} else {
+			/* Sector partially in the range: preserve the data outside the range. */
+			if (rmw_buf == NULL)
+				return -1;
+			memcpy(rmw_buf, (void *)(SPIFLASH_BASE + sector), SPI_FLASH_SECTOR_SIZE);
+			memcpy(rmw_buf + (lo - sector), sdata, hi - lo);
+			spiflash_erase_block(sector, SPI_FLASH_SECTOR_SIZE);
+			spiflash_mmap_sync();
+			spiflash_program(sector, rmw_buf, SPI_FLASH_SECTOR_SIZE);
+			return spiflash_verify(lo, sdata, hi - lo);
 		}
+		spiflash_mmap_sync();
+	}
+	spiflash_program(lo, sdata, hi - lo);
+	return spiflash_verify(lo, sdata, hi - lo);
+}
 
-		for (j = 0; j < w_len; j++) {
-			uint8_t* peek = (((uint8_t*)SPIFLASH_BASE)+addr+offset+j);
-			if (*peek != stream[offset+j]) {
-				printf("Error: verify failed at 0x%08lx (0x%02x should be 0x%02x)\n", (uint32_t)peek, *peek, stream[offset+j]);
+int spiflash_write_range(uint32_t addr, uint8_t *data, uint32_t len, uint8_t *rmw_buf)
+{
+	uint32_t block, block_end, sector, end;
+	uint32_t erased, full, erase_mask, size;
+	uint8_t  states[64*1024/SPI_FLASH_SECTOR_SIZE];
+	int i, n, ret;
+	unsigned int nerased = 0, nprogrammed = 0, nskipped = 0;
+
+	end = addr + len;
+
+	/* Without read-modify-write buffer, check upfront that the partially written first/last
+	   sectors don't need an erase (that would lose the data outside of the range). */
+	if (rmw_buf == NULL) {
+		spiflash_mmap_sync();
+		for (i=0; i<2; i++) {
+			uint32_t lo, hi;
+			sector = ((i == 0) ? addr : (end - 1)) & ~(SPI_FLASH_SECTOR_SIZE - 1);
+			lo     = max(addr, sector);
+			hi     = min(end,  sector + SPI_FLASH_SECTOR_SIZE);
+			if ((len == 0) || ((hi - lo) == SPI_FLASH_SECTOR_SIZE))
+				continue;
+			if (spiflash_sector_state(lo, data + (lo - addr), hi - lo) == SPIFLASH_SECTOR_ERASE) {
+				printf("Error: sector 0x%08lx partially written and needs an erase (use a sector aligned range or a read-modify-write buffer)\n", sector);
+				return -1;
+			}
+		}
+	}
+	for (block = addr & ~(64*1024 - 1); block < end; block += 64*1024) {
+		/* Compare the 4KB sectors of the 64KB block with the new data. */
+		spiflash_mmap_sync();
+		n = sizeof(states);
+		erase_mask = 0;
+		full       = 0;
+		for (i=0; i<n; i++) {
+			uint32_t lo, hi;
+			sector = block + i*SPI_FLASH_SECTOR_SIZE;
+			lo     = max(addr, sector);
+			hi     = min(end,  sector + SPI_FLASH_SECTOR_SIZE);
+			if (lo >= hi) {
+				states[i] = SPIFLASH_SECTOR_SAME;
+				continue;
 			}
+			states[i] = spiflash_sector_state(lo, data + (lo - addr), hi - lo);
+			if (states[i] == SPIFLASH_SECTOR_ERASE)
+				erase_mask |= (1 << i);
+			if ((hi - lo) == SPI_FLASH_SECTOR_SIZE)
+				full |= (1 << i);
 		}
 
-		offset += w_len;
-		w_len = min(len-offset, SPI_FLASH_BLOCK_SIZE);
-		res = offset;
+		/* Erase groups of full sectors with 64KB/32KB erases when possible. */
+		erased = 0;
+		block_end = block + 64*1024;
+		for (sector = block; sector < block_end; sector += size) {
+			uint32_t mask = 0;
+			size = spiflash_erase_block_size(sector, block_end - sector);
+			while (size > SPI_FLASH_SECTOR_SIZE) {
+				mask = ((1 << (size/SPI_FLASH_SECTOR_SIZE)) - 1) << ((sector - block)/SPI_FLASH_SECTOR_SIZE);
+				if ((erase_mask & full & mask) == mask)
+					break;
+				size = (size == 64*1024) ? 32*1024 : SPI_FLASH_SECTOR_SIZE;
+			}
+			if (size > SPI_FLASH_SECTOR_SIZE) {
+				printf("Erase SPI Flash @0x%08lx (%ldKB)\n", sector, size/1024);
+				spiflash_erase_block(sector, size);
+				erased |= mask;
+			}
+		}
+		spiflash_mmap_sync();
+
+		/* Erase remaining sectors individually and program. */
+		for (i=0; i<n; i++) {
+			sector = block + i*SPI_FLASH_SECTOR_SIZE;
+			if (states[i] == SPIFLASH_SECTOR_SAME) {
+				if ((sector < end) && (sector + SPI_FLASH_SECTOR_SIZE > addr))
+					nskipped++;
+				continue;
+			}
+			if (states[i] == SPIFLASH_SECTOR_ERASE)
+				nerased++;
+			else
+				nprogrammed++;
+			ret = spiflash_write_sector(sector, addr, data, len,
+				(states[i] == SPIFLASH_SECTOR_PROGRAM) || (erased & (1 << i)), rmw_buf);
+			if (ret <= 0) {
+				printf("Error: %s in sector 0x%08lx\n", (ret < 0) ? "no read-modify-write buffer" : "verify failed", sector);
+				return -1;
+			}
+		}
 	}
-#ifdef SPIFLASH_DEBUG
-  printf("\n");
-#endif
-	return res;
+	printf("SPI Flash: %d sectors erased+programmed, %d programmed, %d skipped.\n",
+		nerased, nprogrammed, nskipped);
+	return len;
 }
 
 #endif
@@ -285,6 +541,7 @@ void spiflash_memspeed(void) {
 
 void spiflash_init(void)
 {
+	trace_point("spiflash_init");
 	printf("\nInitializing %s SPI Flash @0x%08lx...\n", SPIFLASH_MODULE_NAME, SPIFLASH_BASE);
 
 #ifdef SPIFLASH_MODULE_DUMMY_BITS
@@ -312,10 +569,12 @@ void spiflash_init(void)
 
 #ifndef SPIFLASH_SKIP_FREQ_INIT
 	/* Clk frequency auto-calibration. */
+	trace_point("spiflash_freq_init");
 	spiflash_freq_init();
 #endif
 
 	/* Test SPI Flash speed */
+	trace_point("spiflash_memspeed");
 	spiflash_memspeed();
 }
 
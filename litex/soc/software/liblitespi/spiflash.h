@@ -6,6 +6,7 @@ extern "C" {
 #endif
 
 #define SPI_FLASH_BLOCK_SIZE 256
+#define SPI_FLASH_SECTOR_SIZE (4*1024)
 #define CRC32_ERASED_FLASH	 0xFEA8A821
 
 int spiflash_freq_init(void);
@@ -13,7 +14,27 @@ void spiflash_dummy_bits_setup(unsigned int dummy_bits);
 void spiflash_memspeed(void);
 void spiflash_init(void);
 int spiflash_write_stream(uint32_t addr, uint8_t *stream, uint32_t len);
-void spiflash_erase_range(uint32_t addr, uint32_t len);
+/* Erase a range of whole 4KB sectors (returns -1 if not sector aligned or not erased). */
+int spiflash_erase_range(uint32_t addr, uint32_t len);
+/* Write a range, erasing only the sectors that require it. A partially written sector that needs
+   an erase is saved to rmw_buf (SPI_FLASH_SECTOR_SIZE bytes, caller provided, clobbered) and
+   restored around the range; without rmw_buf (NULL), the write is refused (returns -1). */
+int spiflash_write_range(uint32_t addr, uint8_t *data, uint32_t len, uint8_t *rmw_buf);
+
+/* Compare data with the flash content at addr (reads through the mmap). */
+#define SPIFLASH_SECTOR_SAME    0 /* Already contains the data. */
+#define SPIFLASH_SECTOR_PROGRAM 1 /* Only needs 1->0 bit transitions: program without erase. */
+#define SPIFLASH_SECTOR_ERASE   2 /* Needs erase + program. */
+int spiflash_sector_state(uint32_t addr, uint8_t *data, uint32_t len);
+
+/* Non-blocking primitives: start an erase/page program and poll spiflash_busy() (status register
+   WIP bit) for completion. Reads through the mmap must be preceded by spiflash_mmap_sync(). */
+uint32_t spiflash_read_status_register(void);
+int spiflash_busy(void);
+uint32_t spiflash_erase_block_size(uint32_t addr, uint32_t len);
+void spiflash_erase_block_start(uint32_t addr, uint32_t size);
+void spiflash_page_program_start(uint32_t addr, uint8_t *data, uint32_t len);
+void spiflash_mmap_sync(void);
 
 #ifdef __cplusplus
 }
@@ -12,6 +12,7 @@ import time
 import threading
 import argparse
 import socket
+import struct
 
 from litex.tools.remote.etherbone import EtherbonePacket, EtherboneRecord
 from litex.tools.remote.etherbone import EtherboneReads, EtherboneWrites
@@ -53,6 +54,7 @@ class RemoteClient(EtherboneIPC, CSRBuilder):
         if self.binded:
             return
         self.socket = socket.create_connection((self.host, self.port), 5.0)
+        self.socket.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1) # Small requests: no Nagle delay.
         self.socket.settimeout(5.0)
         self._receive_server_info()
         self.binded = True
@@ -114,6 +116,45 @@ class RemoteClient(EtherboneIPC, CSRBuilder):
             for i, data in enumerate(datas):
                 print("write 0x{:08x} @ 0x{:08x}".format(data, self.base_address + addr + 4*i))
 
+    # Bulk memory access -------------------------------------------------------------------------
+
+    def read_block(self, addr, length, pipeline=4):
+        """Read length bytes (multiple of 4) from addr as bytes (little-endian words), with up to
+        pipeline Etherbone requests of 255 words in flight."""
+        assert length % 4 == 0
+        addr_size = self.csr_bus_address_width // 8
+        chunks    = [(addr + 4*offset, min(255, length//4 - offset)) for offset in range(0, length//4, 255)]
+        data      = bytearray()
+        sent      = 0
+        for i in range(len(chunks)):
+            while (sent < len(chunks)) and (sent < i + pipeline):
+                record = EtherboneRecord(addr_size)
+                record.reads  = EtherboneReads(
+                    addr_size = addr_size,
+                    addrs     = [self.base_address + chunks[sent][0] + 4*j for j in range(chunks[sent][1])]
+                )
+                record.rcount = len(record.reads)
+                packet = EtherbonePacket(self.csr_bus_address_width)
+                packet.records = [record]
+                packet.encode()
+                self.send_packet(self.socket, packet)
+                sent += 1
+            packet = EtherbonePacket(
+                addr_width = self.csr_bus_address_width,
+                init       = self.receive_packet(self.socket, addr_size)
+            )
+            packet.decode()
+            datas = packet.records.pop().writes.get_datas()
+            data += struct.pack(f"<{len(datas)}I", *datas)
+        return bytes(data)
+
+    def write_block(self, addr, data):
+        """Write bytes (padded to a multiple of 4, little-endian words) to addr."""
+        data  = bytes(data) + bytes(-len(data) % 4)
+        words = struct.unpack(f"<{len(data)//4}I", data)
+        for offset in range(0, len(words), 255):
+            self.write(addr + 4*offset, list(words[offset:offset + 255]))
+
 # Utils --------------------------------------------------------------------------------------------
 
 def reg2addr(host, csr_csv, reg):
@@ -157,15 +198,43 @@ def read_memory(host, csr_csv, port, addr, length, binary=False):
     bus = RemoteClient(host=host, csr_csv=csr_csv, port=port)
     bus.open()
 
-    for offset in range(length//4):
+    data = bus.read_block(addr, 4*(length//4))
+    for offset, value in enumerate(struct.unpack(f"<{length//4}I", data)):
         register_value = {
-            True  : f"0b{bus.read(addr + 4*offset):032b}",
-            False : f"0x{bus.read(addr + 4*offset):08x}",
+            True  : f"0b{value:032b}",
+            False : f"0x{value:08x}",
         }[binary]
         print(f"0x{addr + 4*offset:08x} : {register_value}")
 
     bus.close()
 
+def load_memory(host, csr_csv, port, filename, addr):
+    bus = RemoteClient(host=host, csr_csv=csr_csv, port=port)
+    bus.open()
+
+    with open(filename, "rb") as f:
+        data = f.read()
+    start = time.time()
+    bus.write_block(addr, data)
+    bus.read(addr) # Wait for the writes to complete.
+    duration = time.time() - start
+    print(f"Loaded {len(data)} bytes to 0x{addr:08x} ({len(data)/duration/1e3:.1f} KB/s).")
+
+    bus.close()
+
+def dump_memory(host, csr_csv, port, filename, addr, length):
+    bus = RemoteClient(host=host, csr_csv=csr_csv, port=port)
+    bus.open()
+
+    start = time.time()
+    data  = bus.read_block(addr, 4*((length + 3)//4))[:length]
+    duration = time.time() - start
+    with open(filename, "wb") as f:
+        f.write(data)
+    print(f"Dumped {len(data)} bytes from 0x{addr:08x} ({len(data)/duration/1e3:.1f} KB/s).")
+
+    bus.close()
+
 def write_memory(host, csr_csv, port, addr, data):
     bus = RemoteClient(host=host, csr_csv=csr_csv, port=port)
     bus.open()
@@ -393,6 +462,8 @@ def main():
     parser.add_argument("--read",    default=None,          help="Do a MMAP Read to SoC bus (--read addr/reg).")
     parser.add_argument("--write",   default=None, nargs=2, help="Do a MMAP Write to SoC bus (--write addr/reg data).")
     parser.add_argument("--length",  default="4",           help="MMAP access length.")
+    parser.add_argument("--load",    default=None, nargs=2, help="Load a binary file to SoC bus (--load file addr).")
+    parser.add_argument("--dump",    default=None, nargs=3, help="Dump SoC bus to a binary file (--dump file addr length).")
     parser.add_argument("--gui",     action="store_true",   help="Run Gui.")
     args = parser.parse_args()
 
@@ -443,6 +514,25 @@ def main():
             data    = int(args.write[1], 0),
         )
 
+    if args.load:
+        load_memory(
+            host     = args.host,
+            csr_csv  = csr_csv,
+            port     = port,
+            filename = args.load[0],
+            addr     = int(args.load[1], 0),
+        )
+
+    if args.dump:
+        dump_memory(
+            host     = args.host,
+            csr_csv  = csr_csv,
+            port     = port,
+            filename = args.dump[0],
+            addr     = int(args.dump[1], 0),
+            length   = int(args.dump[2], 0),
+        )
+
     if args.gui:
         run_gui(
             host    = args.host,
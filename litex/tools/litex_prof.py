@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+
+#
+# This file is part of LiteX.
+#
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Symbolize the histograms of the firmware statistical profiler (libbase/profiler, BIOS "prof"
+# command) against the ELF of the profiled firmware.
+#
+# The histogram is read from a console log ("prof dump" output captured from litex_term) or
+# received over UDP ("prof send").
+
+import re
+import sys
+import socket
+import struct
+import argparse
+import bisect
+
+# ELF Symbols --------------------------------------------------------------------------------------
+
+def elf_functions(filename):
+    """Return the sorted list of (address, size, name) of the function symbols of an ELF file."""
+    with open(filename, "rb") as f:
+        data = f.read()
+    if data[:4] != b"\x7fELF":
+        raise ValueError(f"{filename} is not an ELF file")
+    is64   = (data[4] == 2)
+    endian = "<" if data[5] == 1 else ">"
+
+    # Section headers.
+    if is64:
+        e_shoff, = struct.unpack_from(endian + "Q", data, 0x28)
+        e_shentsize, e_shnum = struct.unpack_from(endian + "HH", data, 0x3a)
+        sh_fmt, sym_fmt, sym_size = "IIQQQQIIQQ", "IBBHQQ", 24
+    else:
+        e_shoff, = struct.unpack_from(endian + "I", data, 0x20)
+        e_shentsize, e_shnum = struct.unpack_from(endian + "HH", data, 0x2e)
+        sh_fmt, sym_fmt, sym_size = "IIIIIIIIII", "IIIBBH", 16
+    sections = [struct.unpack_from(endian + sh_fmt, data, e_shoff + i*e_shentsize) for i in range(e_shnum)]
+
+    functions = {}
+    for sh in sections:
+        sh_type, sh_offset, sh_size, sh_link = sh[1], sh[4], sh[5], sh[6]
+        if sh_type != 2: # SHT_SYMTAB
+            continue
+        strtab_offset = sections[sh_link][4]
+        for i in range(sh_size//sym_size):
+            fields = struct.unpack_from(endian + sym_fmt, data, sh_offset + i*sym_size)
+            if is64:
+                st_name, st_info, _, _, st_value, st_size = fields
+            else:
+                st_name, st_value, st_size, st_info, _, _ = fields
+            if (st_info & 0xf) != 2: # STT_FUNC
+                continue
+            end  = data.index(b"\x00", strtab_offset + st_name)
+            name = data[strtab_offset + st_name:end].decode(errors="replace")
+            functions[st_value] = (st_value, st_size, name)
+    return sorted(functions.values())
+
+def symbolize(functions, address):
+    addresses = [f[0] for f in functions]
+    i = bisect.bisect_right(addresses, address) - 1
+    if i < 0:
+        return None
+    start, size, name = functions[i]
+    if size and address >= start + size:
+        return None
+    return name
+
+# Histogram ----------------------------------------------------------------------------------------
+
+header_re = re.compile(r"prof: base=(0x[0-9a-fA-F]+) shift=(\d+) buckets=(\d+) rate=(\d+) samples=(\d+) outside=(\d+)")
+bucket_re = re.compile(r"prof: (0x[0-9a-fA-F]+) (\d+)")
+
+def parse_histogram(lines):
+    """Parse the last complete histogram of a prof dump."""
+    header, buckets, histogram = None, {}, None
+    for line in lines:
+        m = header_re.search(line)
+        if m:
+            header  = {k: int(v, 0) for k, v in zip(["base", "shift", "buckets", "rate", "samples", "outside"], m.groups())}
+            buckets = {}
+            continue
+        if header is None:
+            continue
+        if "prof: end" in line:
+            histogram = (header, buckets)
+            continue
+        m = bucket_re.search(line)
+        if m:
+            buckets[int(m.group(1), 0)] = int(m.group(2))
+    return histogram
+
+def receive_histogram(port, timeout):
+    lines = []
+    sock  = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(("", port))
+    sock.settimeout(timeout)
+    try:
+        while True:
+            data, _ = sock.recvfrom(2048)
+            lines += data.decode(errors="replace").splitlines()
+            if "prof: end" in lines[-1]:
+                break
+    except socket.timeout:
+        pass
+    sock.close()
+    return lines
+
+# Report -------------------------------------------------------------------------------------------
+
+def report(histogram, functions, top):
+    header, buckets = histogram
+    samples = max(header["samples"], 1)
+    print(f"{header['samples']} samples at {header['rate']} Hz, {header['outside']} outside of profiled range, "
+          f"{1 << header['shift']} bytes/bucket.")
+
+    counts = {}
+    for address, count in buckets.items():
+        name = symbolize(functions, address) if functions else None
+        name = name or f"0x{address:08x}"
+        counts[name] = counts.get(name, 0) + count
+    if header["outside"]:
+        counts["<outside>"] = header["outside"]
+
+    print(f"{'Samples':>10} {'%':>7}  Function")
+    for name, count in sorted(counts.items(), key=lambda x: x[1], reverse=True)[:top]:
+        print(f"{count:>10} {100.0*count/samples:>6.2f}%  {name}")
+
+# Run ----------------------------------------------------------------------------------------------
+
+def main():
+    parser = argparse.ArgumentParser(description="LiteX firmware profiler histogram symbolizer.", formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+    parser.add_argument("--elf",     default=None,        help="ELF of the profiled firmware (ex: build/<target>/software/bios/bios.elf).")
+    parser.add_argument("--log",     default=None,        help="Console log containing a 'prof dump' output ('-' for stdin).")
+    parser.add_argument("--udp",     default=None,        help="Receive the histogram ('prof send') on this UDP port.")
+    parser.add_argument("--timeout", default=10.0,        help="UDP receive timeout (s).", type=float)
+    parser.add_argument("--top",     default=30,          help="Number of functions to report.", type=int)
+    args = parser.parse_args()
+
+    if args.udp is not None:
+        lines = receive_histogram(int(args.udp, 0), args.timeout)
+    elif args.log == "-":
+        lines = sys.stdin.read().splitlines()
+    elif args.log is not None:
+        with open(args.log, errors="replace") as f:
+            lines = f.read().splitlines()
+    else:
+        parser.error("--log or --udp required.")
+
+    histogram = parse_histogram(lines)
+    if histogram is None:
+        print("No complete profiler histogram found.")
+        sys.exit(1)
+
+    functions = elf_functions(args.elf) if args.elf is not None else []
+    report(histogram, functions, args.top)
+
+if __name__ == "__main__":
+    main()
@@ -15,6 +15,7 @@ import sys
 import socket
 import time
 import threading
+import collections
 
 from litex.tools.remote.etherbone import EtherbonePacket, EtherboneRecord, EtherboneWrites
 from litex.tools.remote.etherbone import EtherboneIPC
@@ -69,13 +70,32 @@ def _read_merger(addrs, max_length=256, bursts=["incr", "fixed"]):
 
 # Remote Server ------------------------------------------------------------------------------------
 
+class RemoteRequest:
+    """Etherbone record of a client, executed by the dispatcher thread."""
+    def __init__(self, record):
+        self.record = record
+        self.reads  = None
+        self.error  = None
+        self.done   = threading.Event()
+
+
 class RemoteServer(EtherboneIPC):
+    """Etherbone TCP server in front of a comm link.
+
+    Each client connection is served by its own thread that queues its requests; a single
+    dispatcher thread owns the comm link and executes one request per client in round-robin
+    (so a client doing a large transfer does not starve the others), with the reads of all the
+    requests of a round merged in bursts. A comm error only fails (disconnects) the client whose
+    request caused it.
+    """
     def __init__(self, comm, bind_ip, bind_port=1234, addr_width=32):
         self.comm       = comm
         self.bind_ip    = bind_ip
         self.bind_port  = bind_port
-        self.lock       = False
         self.addr_width = addr_width
+        self.clients    = []                      # Per-client request queues.
+        self.clients_cv = threading.Condition()
+        self.rr_index   = 0
 
     def open(self):
         if hasattr(self, "socket"):
@@ -106,11 +126,103 @@ class RemoteServer(EtherboneIPC):
         info = ":".join(info)
         client_socket.sendall(bytes(info, "UTF-8"))
 
+    def _read(self, addrs):
+        max_length = {
+            "CommUART": 255,
+            "CommUDP":  255, # Split to comm.max_burst words by read_bursts().
+        }.get(self.comm.__class__.__name__, 1)
+        bursts = {
+            "CommUART": ["incr", "fixed"]
+        }.get(self.comm.__class__.__name__, ["incr"])
+        merged = _read_merger(addrs,
+            max_length  = max_length,
+            bursts      = bursts)
+        reads = []
+        if hasattr(self.comm, "read_bursts"):
+            # Pipelined bursts (CommUDP).
+            reads = self.comm.read_bursts([(addr, length) for addr, length, burst in merged])
+        else:
+            for addr, length, burst in merged:
+                reads += self.comm.read(addr, length, burst)
+        return reads
+
+    def _execute(self, requests):
+        # Errors are attributed to the request causing them (request.error): the other requests of
+        # the round are still executed/answered.
+
+        # Handle Etherbone writes (in order, before the reads of their request).
+        for request in requests:
+            record = request.record
+            if record.writes != None:
+                try:
+                    self.comm.write(record.writes.base_addr, record.writes.get_datas())
+                except Exception as e:
+                    request.error = e
+
+        # Handle Etherbone reads (merged across requests).
+        readers = [r for r in requests if (r.error is None) and (r.record.reads != None)]
+        if not readers:
+            return
+        addrs = []
+        for request in readers:
+            addrs += request.record.reads.get_addrs()
+        try:
+            reads = self._read(addrs)
+        except Exception:
+            # Merged reads failed: do them again per request to find the failing one(s).
+            for request in readers:
+                try:
+                    request.reads = self._read(request.record.reads.get_addrs())
+                except Exception as e:
+                    request.error = e
+            return
+        offset = 0
+        for request in readers:
+            length = len(request.record.reads.get_addrs())
+            request.reads = reads[offset:offset + length]
+            offset += length
+
+    def _dispatch_thread(self):
+        while True:
+            # Take the oldest request of each client, starting from a rotating client.
+            with self.clients_cv:
+                while not any(self.clients):
+                    self.clients_cv.wait()
+                n = len(self.clients)
+                requests = []
+                for i in range(n):
+                    queue = self.clients[(self.rr_index + i) % n]
+                    if queue:
+                        requests.append(queue.popleft())
+                self.rr_index = (self.rr_index + 1) % n
+
+            try:
+                self._execute(requests)
+            except Exception as e:
+                # Unexpected error (not attributed to a request).
+                for request in requests:
+                    if request.error is None:
+                        request.error = e
+            for request in requests:
+                request.done.set()
+
+    def _submit(self, queue, record):
+        request = RemoteRequest(record)
+        with self.clients_cv:
+            queue.append(request)
+            self.clients_cv.notify()
+        request.done.wait()
+        return request
+
     def _serve_thread(self):
         while True:
             client_socket, addr = self.socket.accept()
+            client_socket.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1) # Small responses: no Nagle delay.
             self._send_server_info(client_socket)
             print("Connected with " + addr[0] + ":" + str(addr[1]))
+            queue = collections.deque()
+            with self.clients_cv:
+                self.clients.append(queue)
             try:
                 # Serve Etherbone reads/writes.
                 while True:
@@ -128,33 +240,17 @@ class RemoteServer(EtherboneIPC):
                     # Get Packet's Record.
                     record = packet.records.pop()
 
-                    # Hardware lock/reservation.
-                    while self.lock:
-                        time.sleep(0.01)
-                    self.lock = True
-
-                    # Handle Etherbone writes.
-                    if record.writes != None:
-                        self.comm.write(record.writes.base_addr, record.writes.get_datas())
+                    # Execute it on the comm link (through the dispatcher).
+                    request = self._submit(queue, record)
+                    if request.error is not None:
+                        print("Error: {}".format(request.error))
+                        break
 
-                    # Handle Etherbone reads.
+                    # Send reads response.
                     if record.reads != None:
-                        max_length = {
-                            "CommUART": 256,
-                            "CommUDP":    1,
-                        }.get(self.comm.__class__.__name__, 1)
-                        bursts = {
-                            "CommUART": ["incr", "fixed"]
-                        }.get(self.comm.__class__.__name__, ["incr"])
-                        reads = []
-                        for addr, length, burst in _read_merger(record.reads.get_addrs(),
-                            max_length  = max_length,
-                            bursts      = bursts):
-                            reads += self.comm.read(addr, length, burst)
-
                         addr_size = self.addr_width // 8
                         record = EtherboneRecord(addr_size)
-                        record.writes = EtherboneWrites(addr_size=addr_size, datas=reads)
+                        record.writes = EtherboneWrites(addr_size=addr_size, datas=request.reads)
                         record.wcount = len(record.writes)
 
                         packet = EtherbonePacket(self.addr_width)
@@ -162,14 +258,17 @@ class RemoteServer(EtherboneIPC):
                         packet.encode()
                         self.send_packet(client_socket, packet)
 
-                    # Release hardware lock.
-                    self.lock = False
-
             finally:
+                with self.clients_cv:
+                    # By identity (deques compare by content).
+                    self.clients = [q for q in self.clients if q is not queue]
                 print("Disconnect")
                 client_socket.close()
 
     def start(self, nthreads):
+        self.dispatch_thread = threading.Thread(target=self._dispatch_thread)
+        self.dispatch_thread.setDaemon(True)
+        self.dispatch_thread.start()
         for i in range(nthreads):
             self.serve_thread = threading.Thread(target=self._serve_thread)
             self.serve_thread.setDaemon(True)
@@ -189,6 +288,7 @@ def main():
     parser.add_argument("--uart",            action="store_true",    help="Select UART interface.")
     parser.add_argument("--uart-port",       default=None,           help="Set UART port.")
     parser.add_argument("--uart-baudrate",   default=115200,         help="Set UART baudrate.")
+    parser.add_argument("--uart-pipeline",   default=1,              help="Set UART outstanding read commands (>1 requires UARTBone RX FIFO).")
 
     # JTAG arguments
     parser.add_argument("--jtag",            action="store_true",             help="Select JTAG interface.")
@@ -200,6 +300,12 @@ def main():
     parser.add_argument("--udp-ip",          default="192.168.1.50", help="Set UDP remote IP address.")
     parser.add_argument("--udp-port",        default=1234,           help="Set UDP remote port.")
     parser.add_argument("--udp-scan",        action="store_true",    help="Scan network for available UDP devices.")
+    parser.add_argument("--udp-mtu",         default=1500,           help="Set UDP MTU (limits the size of pipelined read packets).")
+    parser.add_argument("--udp-max-burst",   default=16,             help="Set UDP max words per read/write record (16 for hardware Etherbone, up to 255 for CPU servers).")
+    parser.add_argument("--udp-max-records", default=1,              help="Set UDP max records per packet (1 for hardware Etherbone, 0 for MTU limited with CPU servers).")
+    parser.add_argument("--udp-window",      default=4,              help="Set UDP window (outstanding read packets, 1 to disable pipelining).")
+    parser.add_argument("--udp-write-ack",   action="store_true",    help="Acknowledge UDP writes (for CPU Etherbone servers, ex BIOS eth_etherbone).")
+    parser.add_argument("--udp-write-retry", action="store_true",    help="Resend unacknowledged UDP writes (replays them, idempotent writes only).")
 
     # PCIe arguments
     parser.add_argument("--pcie",            action="store_true",    help="Select PCIe interface.")
@@ -222,7 +328,8 @@ def main():
         uart_port = args.uart_port
         uart_baudrate = int(float(args.uart_baudrate))
         print("[CommUART] port: {} / baudrate: {} / ".format(uart_port, uart_baudrate), end="")
-        comm = CommUART(uart_port, uart_baudrate, debug=args.debug, addr_width=int(args.addr_width))
+        comm = CommUART(uart_port, uart_baudrate, debug=args.debug, addr_width=int(args.addr_width),
+            pipeline = int(args.uart_pipeline))
 
     # JTAG mode
     elif args.jtag:
@@ -231,7 +338,8 @@ def main():
         jtag_uart = JTAGUART(config=args.jtag_config, chain=int(args.jtag_chain))
         jtag_uart.open()
         print("[CommUART] port: JTAG / ", end="")
-        comm = CommUART(os.ttyname(jtag_uart.name), debug=args.debug, addr_width=int(args.addr_width))
+        comm = CommUART(os.ttyname(jtag_uart.name), debug=args.debug, addr_width=int(args.addr_width),
+            pipeline = int(args.uart_pipeline))
 
     # UDP mode
     elif args.udp:
@@ -250,7 +358,13 @@ def main():
             exit()
         else:
             print("[CommUDP] ip: {} / port: {} / ".format(udp_ip, udp_port), end="")
-            comm = CommUDP(udp_ip, udp_port, debug=args.debug, addr_width=int(args.addr_width))
+            comm = CommUDP(udp_ip, udp_port, debug=args.debug, addr_width=int(args.addr_width),
+                mtu         = int(args.udp_mtu),
+                max_burst   = int(args.udp_max_burst),
+                max_records = int(args.udp_max_records) or None,
+                window      = int(args.udp_window),
+                write_ack   = args.udp_write_ack,
+                write_retry = args.udp_write_retry)
 
     # PCIe mode
     elif args.pcie:
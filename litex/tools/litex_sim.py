@@ -138,6 +138,19 @@ _io = [
         Subsignal("ntrst", Pins(1)),
     ),
 
+    # DMI (RISC-V Debug Module Interface).
+    ("dmi", 0,
+        Subsignal("req_valid",  Pins(1)),
+        Subsignal("req_ready",  Pins(1)),
+        Subsignal("req_addr",   Pins(7)),
+        Subsignal("req_op",     Pins(2)),
+        Subsignal("req_data",   Pins(32)),
+        Subsignal("resp_valid", Pins(1)),
+        Subsignal("resp_ready", Pins(1)),
+        Subsignal("resp_data",  Pins(32)),
+        Subsignal("resp_resp",  Pins(2)),
+    ),
+
     # Video (VGA).
     ("vga", 0,
         Subsignal("hsync", Pins(1)),
@@ -177,12 +190,15 @@ class SimSoC(SoCCore):
         with_spi_flash        = False,
         spi_flash_init        = [],
         with_gpio             = False,
+        with_dma_copy         = False,
+        with_crc              = False,
         with_video_framebuffer = False,
         with_video_terminal = False,
         with_video_colorbars = False,
         sim_debug             = False,
         trace_reset_on        = False,
         with_jtag             = False,
+        with_dmi              = False,
         **kwargs):
         platform     = Platform()
         sys_clk_freq = int(1e6)
@@ -300,6 +316,13 @@ class SimSoC(SoCCore):
             jtag_pads = platform.request("jtag")
             self.cpu.add_jtag(jtag_pads)
 
+        # DMI --------------------------------------------------------------------------------------
+        if with_dmi:
+            if not hasattr(self.cpu, "add_dmi"):
+                raise ValueError(f"{self.cpu.name} CPU does not expose its Debug Module Interface.")
+            dmi_pads = platform.request("dmi")
+            self.cpu.add_dmi(dmi_pads)
+
         # SDCard -----------------------------------------------------------------------------------
         if with_sdcard:
             self.add_sdcard("sdcard", use_emulator=True)
@@ -316,6 +339,14 @@ class SimSoC(SoCCore):
             self.spiflash_phy = LiteSPIPHYModel(spiflash_module, init=spi_flash_init)
             self.add_spi_flash(phy=self.spiflash_phy, mode="4x", module=spiflash_module, with_master=True)
 
+        # DMA Copy ---------------------------------------------------------------------------------
+        if with_dma_copy:
+            self.add_dma_copy()
+
+        # CRC32 ------------------------------------------------------------------------------------
+        if with_crc:
+            self.add_crc()
+
         # GPIO --------------------------------------------------------------------------------------
         if with_gpio:
             self.gpio = GPIOTristate(platform.request("gpio"), with_irq=True)
@@ -437,11 +468,18 @@ def sim_args(parser):
     parser.add_argument("--with-spi-flash",       action="store_true",     help="Enable SPI Flash (MMAPed).")
     parser.add_argument("--spi_flash-init",       default=None,            help="SPI Flash init file.")
 
+    # DMA Copy.
+    parser.add_argument("--with-dma-copy",        action="store_true",     help="Enable DMA Copy/Fill engine.")
+
+    # CRC32.
+    parser.add_argument("--with-crc",             action="store_true",     help="Enable CRC32 accelerator.")
+
     # I2C.
     parser.add_argument("--with-i2c",             action="store_true",     help="Enable I2C support.")
 
     # JTAG
     parser.add_argument("--with-jtagremote",      action="store_true", help="Enable jtagremote support")
+    parser.add_argument("--with-dmiremote",       action="store_true", help="Enable direct Debug Module Interface access (OpenOCD jtag_vpi) support")
 
     # GPIO.
     parser.add_argument("--with-gpio",            action="store_true",     help="Enable Tristate GPIO (32 pins).")
@@ -534,6 +572,8 @@ def main():
     # JTAG
     if args.with_jtagremote:
         sim_config.add_module("jtagremote", "jtag", args={'port': 44853})
+    if args.with_dmiremote:
+        sim_config.add_module("dmiremote", "dmi", args={'port': 5555})
 
     # Video.
     if args.with_video_framebuffer or args.with_video_terminal or args.with_video_colorbars:
@@ -549,9 +589,12 @@ def main():
         with_analyzer          = args.with_analyzer,
         with_i2c               = args.with_i2c,
         with_jtag              = args.with_jtagremote,
+        with_dmi               = args.with_dmiremote,
         with_sdcard            = args.with_sdcard,
         with_spi_flash         = args.with_spi_flash,
         with_gpio              = args.with_gpio,
+        with_dma_copy          = args.with_dma_copy,
+        with_crc               = args.with_crc,
         with_video_framebuffer = args.with_video_framebuffer,
         with_video_terminal    = args.with_video_terminal,
         with_video_colorbars   = args.with_video_colorbars,
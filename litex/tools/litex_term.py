@@ -217,6 +217,7 @@ sfl_payload_length  = 255
 sfl_cmd_abort       = b"\x00"
 sfl_cmd_load        = b"\x01"
 sfl_cmd_jump        = b"\x02"
+sfl_cmd_baudrate    = b"\x03"
 
 # Replies
 sfl_ack_success  = b"K"
@@ -287,7 +288,7 @@ def crc16(l):
 # LiteXTerm ----------------------------------------------------------------------------------------
 
 class LiteXTerm:
-    def __init__(self, serial_boot, kernel_image, kernel_address, json_images, safe):
+    def __init__(self, serial_boot, kernel_image, kernel_address, json_images, safe, upload_speed=None):
         self.serial_boot = serial_boot
         assert not (kernel_image is not None and json_images is not None)
         self.mem_regions = {}
@@ -318,10 +319,13 @@ class LiteXTerm:
         self.length      = 64
         self.outstanding = 0 if safe else 128
 
+        self.upload_speed = upload_speed
+
     def open(self, port, baudrate):
         if hasattr(self, "port"):
             return
         self.port = serial.serial_for_url(port, baudrate)
+        self.speed = baudrate
 
     def close(self):
         if not hasattr(self, "port"):
@@ -430,6 +434,46 @@ class LiteXTerm:
             self.length      = 64
             self.outstanding = 0
 
+    def send_baudrate_frame(self, baudrate, test=False):
+        frame = SFLFrame()
+        frame.cmd = sfl_cmd_baudrate
+        frame.payload = baudrate.to_bytes(4, "big")
+        if test:
+            frame.payload += bytes(range(sfl_payload_length - 4))
+        self.port.write(frame.encode())
+        return self.port.read()
+
+    def upshift_baudrate(self):
+        # Try the standard baudrates from upload_speed down to the console speed: the device acks
+        # the request at the current baudrate and switches, the link is then verified with a test
+        # frame at the new baudrate. On failure, the device returns to the previous baudrate after
+        # its timeout (0.5s) and the next baudrate is tried.
+        baudrates = [self.upload_speed] + [
+            3000000, 2000000, 1500000, 1000000, 921600, 500000, 460800, 230400]
+        baudrates = sorted({b for b in baudrates if self.speed < b <= self.upload_speed}, reverse=True)
+        timeout, self.port.timeout = self.port.timeout, 1.0
+        try:
+            for baudrate in baudrates:
+                reply = self.send_baudrate_frame(baudrate)
+                if reply == sfl_ack_error:
+                    continue # Not supported by the device, try a lower baudrate.
+                if reply != sfl_ack_success:
+                    break    # No dynamic baudrate support on the device.
+                try:
+                    self.port.baudrate = baudrate
+                    time.sleep(0.01)
+                    if self.send_baudrate_frame(baudrate, test=True) == sfl_ack_success:
+                        print(f"[LITEX-TERM] Upload baudrate: {baudrate}.")
+                        return
+                except (ValueError, serial.SerialException):
+                    pass # Not supported by the host port.
+                self.port.baudrate = self.speed
+                time.sleep(1.0)
+                self.port.reset_input_buffer()
+            print(f"[LITEX-TERM] Upload baudrate: {self.speed} (no upshift).")
+        finally:
+            self.port.timeout = timeout
+
     def upload(self, filename, address):
         f = open(filename, "rb")
         f.seek(0, 2)
@@ -506,6 +550,9 @@ class LiteXTerm:
         frame.cmd = sfl_cmd_jump
         frame.payload = int(self.boot_address, 16).to_bytes(4, "big")
         self.send_frame(frame)
+        # The device restores the console baudrate after the ack.
+        if self.port.baudrate != self.speed:
+            self.port.baudrate = self.speed
 
     def detect_prompt(self, data):
         if len(data):
@@ -529,6 +576,8 @@ class LiteXTerm:
         print("[LITEX-TERM] Received firmware download request from the device.")
         if(len(self.mem_regions)):
             self.port.write(sfl_magic_ack)
+            if self.upload_speed is not None:
+                self.upshift_baudrate()
         for filename, base in self.mem_regions.items():
             self.upload(filename, int(base, 16))
         self.boot()
@@ -612,6 +661,7 @@ def _get_args():
     parser.add_argument("--kernel-adr",     default="0x40000000",               help="Kernel address.")
     parser.add_argument("--images",         default=None,                       help="JSON description of the images to load to memory.")
     parser.add_argument("--safe",           action="store_true",                help="Safe serial boot mode, disable upload speed optimizations.")
+    parser.add_argument("--upload-speed",   default=None,                       help="Max serial boot upload baudrate (negotiated with the device, requires --uart-dynamic-baudrate).")
 
     parser.add_argument("--csr-csv",        default=None,                       help="SoC CSV file.")
     parser.add_argument("--base-address",   default=None,                       help="CSR base address.")
@@ -624,7 +674,8 @@ def _get_args():
 
 def main():
     args = _get_args()
-    term = LiteXTerm(args.serial_boot, args.kernel, args.kernel_adr, args.images, args.safe)
+    upload_speed = None if args.upload_speed is None else int(float(args.upload_speed))
+    term = LiteXTerm(args.serial_boot, args.kernel, args.kernel_adr, args.images, args.safe, upload_speed)
 
     if sys.platform == "win32":
         if args.port in ["crossover", "jtag"]:
@@ -19,12 +19,21 @@ CMD_READ_BURST_FIXED  = 0x04
 # CommUART -----------------------------------------------------------------------------------------
 
 class CommUART(CSRBuilder):
-    def __init__(self, port, baudrate=115200, csr_csv=None, debug=False, addr_width=32):
+    """UARTBone (Stream2Wishbone protocol) over a serial port.
+
+    Accesses are split in commands of up to max_burst (255) words, encoded/decoded with struct in
+    single port writes/reads. Writes are streamed back to back (no response). Up to pipeline read
+    commands are sent ahead of their responses; pipeline > 1 requires the bridge to buffer the
+    extra commands while it sends read data (UARTBone rx_fifo_depth) and defaults to 1.
+    """
+    def __init__(self, port, baudrate=115200, csr_csv=None, debug=False, addr_width=32, max_burst=255, pipeline=1):
         CSRBuilder.__init__(self, comm=self, csr_csv=csr_csv)
         self.port       = serial.serial_for_url(port, baudrate)
         self.baudrate   = str(baudrate)
         self.debug      = debug
         self.addr_bytes = addr_width // 8
+        self.max_burst  = max(1, min(max_burst, 255))
+        self.pipeline   = max(1, pipeline)
 
     def open(self):
         if hasattr(self, "port"):
@@ -38,12 +47,13 @@ class CommUART(CSRBuilder):
         del self.port
 
     def _read(self, length):
-        r = bytes()
+        r = bytearray()
         while len(r) < length:
             r += self.port.read(length - len(r))
         return r
 
     def _write(self, data):
+        data = memoryview(data)
         remaining = len(data)
         pos = 0
         while remaining:
@@ -55,41 +65,54 @@ class CommUART(CSRBuilder):
         if self.port.inWaiting() > 0:
             self.port.read(self.port.inWaiting())
 
+    def _cmd(self, cmd, length, addr):
+        return bytes([cmd, length]) + (addr//4).to_bytes(self.addr_bytes, byteorder="big")
+
     def read(self, addr, length=None, burst="incr"):
-        self._flush()
-        data       = []
         length_int = 1 if length is None else length
         cmd        = {
             "incr" : CMD_READ_BURST_INCR,
             "fixed": CMD_READ_BURST_FIXED,
         }[burst]
-        self._write([cmd, length_int])
-        self._write(list((addr//4).to_bytes(self.addr_bytes, byteorder="big")))
-        for i in range(length_int):
-            value = int.from_bytes(self._read(4), "big")
-            if self.debug:
+
+        # Commands (address in words for incr bursts, fixed address otherwise).
+        cmds = []
+        for offset in range(0, length_int, self.max_burst):
+            size = min(length_int - offset, self.max_burst)
+            cmds.append((self._cmd(cmd, size, addr + 4*offset*(burst == "incr")), size))
+
+        # Send up to pipeline commands ahead of their responses, responses are returned in order.
+        self._flush()
+        data = bytearray()
+        sent = 0
+        for i in range(len(cmds)):
+            while (sent < len(cmds)) and (sent < i + self.pipeline):
+                self._write(cmds[sent][0])
+                sent += 1
+            data += self._read(4*cmds[i][1])
+        data = list(struct.unpack(f">{length_int}I", data))
+
+        if self.debug:
+            for i, value in enumerate(data):
                 print("read 0x{:08x} @ 0x{:08x}".format(value, addr + 4*i))
-            if length is None:
-                return value
-            data.append(value)
-        return data
+        return data[0] if length is None else data
 
     def write(self, addr, data, burst="incr"):
-        self._flush()
         data   = data if isinstance(data, list) else [data]
         length = len(data)
-        offset = 0
-        while length:
-            size = min(length, 8)
-            cmd = {
-                "incr" : CMD_WRITE_BURST_INCR,
-                "fixed": CMD_WRITE_BURST_FIXED,
-            }[burst]
-            self._write([cmd, size])
-            self._write(list(((addr//4 + offset).to_bytes(self.addr_bytes, byteorder="big"))))
-            for i, value in enumerate(data[offset:offset+size]):
-                self._write(list(value.to_bytes(4, byteorder="big")))
-                if self.debug:
-                    print("write 0x{:08x} @ 0x{:08x}".format(value, addr + offset, 4*i))
-            offset += size
-            length -= size
+        cmd    = {
+            "incr" : CMD_WRITE_BURST_INCR,
+            "fixed": CMD_WRITE_BURST_FIXED,
+        }[burst]
+
+        # Commands + datas, sent as a single stream.
+        stream = bytearray()
+        for offset in range(0, length, self.max_burst):
+            size = min(length - offset, self.max_burst)
+            stream += self._cmd(cmd, size, addr + 4*offset*(burst == "incr"))
+            stream += struct.pack(f">{size}I", *data[offset:offset + size])
+        self._write(stream)
+
+        if self.debug:
+            for i, value in enumerate(data):
+                print("write 0x{:08x} @ 0x{:08x}".format(value, addr + 4*i))
@@ -10,13 +10,34 @@ import time
 
 from litex.tools.remote.etherbone import EtherbonePacket, EtherboneRecord
 from litex.tools.remote.etherbone import EtherboneReads, EtherboneWrites
+from litex.tools.remote.etherbone import etherbone_packet_header_length, etherbone_record_header_length
 
 from litex.tools.remote.csr_builder import CSRBuilder
 
 # CommUDP ------------------------------------------------------------------------------------------
 
 class CommUDP(CSRBuilder):
-    def __init__(self, server="192.168.1.50", port=1234, csr_csv=None, debug=False, timeout=1.0, addr_width=32):
+    """Etherbone over UDP.
+
+    Reads are pipelined: long reads are split in bursts of up to max_burst words, packed as up
+    to max_records records per packet (and up to the MTU), with up to window request packets in
+    flight. Responses are matched to their record by base_ret_addr, lost ones are requested again
+    on timeout (halving the window). window=1 gives the non-pipelined request/response behaviour.
+
+    The defaults (max_burst=16, max_records=1) match the hardware Etherbone core (add_etherbone
+    default buffer_depth=16). CPU Etherbone servers (ex BIOS eth_etherbone command) accept up to
+    255 words per record and several records per packet (max_burst=255, max_records=None, limited
+    by the MTU only).
+
+    Writes are not acknowledged by Etherbone. With write_ack, a 1-word read-back record is added
+    to each write packet and write packets are sent as reads: required with servers that can drop
+    packets under load (ex BIOS eth_etherbone command on SoCs without hardware Etherbone). When the
+    read-back times out, the writes may or may not have been done: socket.timeout is raised, unless
+    write_retry is set, in which case the whole packet is sent again, replaying its writes (only
+    for idempotent writes, ex memories or regular CSRs, not FIFOs or write-to-clear registers).
+    """
+    def __init__(self, server="192.168.1.50", port=1234, csr_csv=None, debug=False, timeout=1.0, addr_width=32,
+        mtu=1500, max_burst=16, max_records=1, window=4, write_ack=False, write_retry=False):
         CSRBuilder.__init__(self, comm=self, csr_csv=csr_csv)
         self.server = server
         self.port   = port
@@ -24,6 +45,12 @@ class CommUDP(CSRBuilder):
         self.timeout= timeout
         self.read_counter = 0
         self.addr_width   = addr_width
+        self.mtu          = mtu
+        self.max_burst    = max(1, min(max_burst, 255))
+        self.max_records  = None if max_records is None else max(1, max_records)
+        self.window       = max(1, window)
+        self.write_ack    = write_ack
+        self.write_retry  = write_retry
 
     def open(self, probe=True):
         if hasattr(self, "socket"):
@@ -81,51 +108,128 @@ class CommUDP(CSRBuilder):
             if self.probe(ip=ip.format(str(i)), port=self.port, loose=True):
                 print("- {}".format(ip.format(i)))
 
-    def read(self, addr, length=None, burst="incr"):
-        assert burst == "incr"
-        length_int = 1 if length is None else length
+    # Reads ----------------------------------------------------------------------------------------
 
-        retries = 10
+    def _payload_max(self):
+        return self.mtu - 20 - 8 # IPv4/UDP headers.
 
-        for r in range(retries):
-            self.read_counter += 1
+    def _packet_full(self, records, length, max_records=None):
+        max_records = self.max_records if max_records is None else max_records
+        if (max_records is not None) and (len(records) >= max_records):
+            return True
+        return length > self._payload_max()
 
+    def _read_packets(self, bursts):
+        """Split bursts in (base_ret_addr, addr, length) records and group them in packets that fit the MTU
+        (and max_records)."""
+        addr_size   = self.addr_width//8
+        packets     = []
+        records     = []
+        req_length  = etherbone_packet_header_length
+        resp_length = etherbone_packet_header_length
+        for addr, length in bursts:
+            for offset in range(0, length, self.max_burst):
+                n     = min(self.max_burst, length - offset)
+                req   = etherbone_record_header_length + (n + 1)*addr_size
+                resp  = etherbone_record_header_length + addr_size + 4*n
+                if records and self._packet_full(records, max(req_length + req, resp_length + resp)):
+                    packets.append(records)
+                    records     = []
+                    req_length  = etherbone_packet_header_length
+                    resp_length = etherbone_packet_header_length
+                self.read_counter = (self.read_counter + 1) % 2**self.addr_width
+                records.append((self.read_counter, addr + 4*offset, n))
+                req_length  += req
+                resp_length += resp
+        if records:
+            packets.append(records)
+        return packets
+
+    def _send_packet(self, records, writes=[]):
+        packet = EtherbonePacket(addr_width=self.addr_width)
+        for addr, datas in writes:
+            record = EtherboneRecord(addr_size=self.addr_width//8)
+            record.writes = EtherboneWrites(addr_size=self.addr_width//8, base_addr=addr, datas=iter(datas))
+            record.wcount = len(record.writes)
+            packet.records.append(record)
+        for base_ret_addr, addr, length in records:
             record = EtherboneRecord(addr_size=self.addr_width//8)
-            record.reads = EtherboneReads(addr_size=self.addr_width//8, addrs=[addr+4*j for j in range(length_int)])
+            record.reads = EtherboneReads(addr_size=self.addr_width//8, addrs=[addr+4*j for j in range(length)])
             record.rcount = len(record.reads)
-            record.reads.base_ret_addr = self.read_counter
+            record.reads.base_ret_addr = base_ret_addr
+            packet.records.append(record)
+        packet.encode()
+        self.socket.sendto(packet.bytes, (self.server, self.port))
 
-            packet = EtherbonePacket(addr_width=self.addr_width)
-            packet.records = [record]
-            packet.encode()
+    def read_bursts(self, bursts):
+        """Read a list of (addr, length) incrementing bursts, return the concatenated datas."""
+        packets = self._read_packets(bursts)
+        results = self._exchange(packets, [[] for p in packets])
+        datas = []
+        for records in packets:
+            for base_ret_addr, addr, length in records:
+                datas += results[base_ret_addr]
+        return datas
 
-            self.socket.sendto(packet.bytes, (self.server, self.port))
+    def _exchange(self, packets, writes, resend_writes=True):
+        """Send packets (read records + writes) with a window of outstanding packets and return
+        the read results (base_ret_addr -> datas). Packets with missing results are sent again
+        (packets with writes only if resend_writes, socket.timeout is raised otherwise)."""
+        results = {}                          # base_ret_addr -> datas.
+        pending = {}                          # base_ret_addr -> packet index.
+        missing = [len(p) for p in packets]   # Records without response per packet.
+        retries = [0]*len(packets)
+        inflight = []
+        next_packet = 0
+        window = self.window
 
-            timed_out = False
-            while True:
-                try:
-                    datas, dummy = self.socket.recvfrom(8192)
-                except socket.timeout:
+        while (next_packet < len(packets)) or inflight:
+            # Fill the window.
+            while (next_packet < len(packets)) and (len(inflight) < window):
+                for record in packets[next_packet]:
+                    pending[record[0]] = next_packet
+                self._send_packet(packets[next_packet], writes[next_packet])
+                inflight.append(next_packet)
+                next_packet += 1
+
+            # Receive responses.
+            try:
+                datas, dummy = self.socket.recvfrom(8192)
+            except socket.timeout:
+                # Request again the records without response.
+                window = max(1, window//2)
+                for i in inflight:
+                    retries[i] += 1
+                    if (retries[i] > 10) or (writes[i] and not resend_writes):
+                        raise socket.timeout
                     if self.debug:
-                        print("socket timeout, retrying ({}/{})".format(r+1, retries))
-                    timed_out = True
-                    break
-
-                packet = EtherbonePacket(self.addr_width, datas)
-                packet.decode()
-                record = packet.records.pop()
-                datas = record.writes.get_datas()
-                if record.writes.base_addr == self.read_counter:
-                    break
-                else:
+                        print("socket timeout, retrying ({}/{})".format(retries[i], 10))
+                    self._send_packet([r for r in packets[i] if r[0] not in results], writes[i])
+                continue
+
+            packet = EtherbonePacket(self.addr_width, datas)
+            packet.decode()
+            for record in packet.records:
+                if record.writes is None:
+                    continue
+                base_ret_addr = record.writes.base_addr
+                i = pending.pop(base_ret_addr, None)
+                if i is None:
                     if self.debug:
-                        print(f"WARNING: request/response id mismatch: 0x{self.read_counter:08x} != 0x{record.writes.base_addr:08x}")
+                        print(f"WARNING: unexpected response id: 0x{base_ret_addr:08x}")
+                    continue
+                results[base_ret_addr] = record.writes.get_datas()
+                missing[i] -= 1
+                if missing[i] == 0:
+                    inflight.remove(i)
 
-            if not timed_out:
-                break
+        return results
 
-        else:
-            raise socket.timeout
+    def read(self, addr, length=None, burst="incr"):
+        assert burst == "incr"
+        length_int = 1 if length is None else length
+
+        datas = self.read_bursts([(addr, length_int)])
 
         if self.debug:
             for i, value in enumerate(datas):
@@ -133,18 +237,43 @@ class CommUDP(CSRBuilder):
 
         return datas[0] if length is None else datas
 
+    # Writes ---------------------------------------------------------------------------------------
+
     def write(self, addr, datas):
         datas = datas if isinstance(datas, list) else [datas]
         length = len(datas)
-        record = EtherboneRecord(addr_size=self.addr_width//8)
-        record.writes = EtherboneWrites(addr_size=self.addr_width//8, base_addr=addr, datas=iter(datas))
-        record.wcount = len(record.writes)
+        addr_size = self.addr_width//8
+        if length == 0:
+            return
 
-        packet = EtherbonePacket(self.addr_width)
-        packet.records = [record]
-        packet.encode()
+        # Split in bursts of up to max_burst words, packed in packets up to the MTU and max_records
+        # (keeping room for the read-back record with write_ack).
+        ack_length    = etherbone_record_header_length + 2*addr_size if self.write_ack else 0
+        max_records   = None
+        if (self.max_records is not None) and self.write_ack:
+            max_records = max(1, self.max_records - 1)
+        packets       = [[]]
+        packet_length = etherbone_packet_header_length + ack_length
+        for offset in range(0, length, self.max_burst):
+            chunk  = datas[offset:offset + self.max_burst]
+            record_length = etherbone_record_header_length + addr_size + 4*len(chunk)
+            if packets[-1] and self._packet_full(packets[-1], packet_length + record_length, max_records):
+                packets.append([])
+                packet_length = etherbone_packet_header_length + ack_length
+            packets[-1].append((addr + 4*offset, chunk))
+            packet_length += record_length
 
-        self.socket.sendto(packet.bytes, (self.server, self.port))
+        if self.write_ack:
+            # Read back the last written word of each packet.
+            acks = []
+            for writes in packets:
+                last_addr, last_chunk = writes[-1]
+                self.read_counter = (self.read_counter + 1) % 2**self.addr_width
+                acks.append([(self.read_counter, last_addr + 4*(len(last_chunk) - 1), 1)])
+            self._exchange(acks, packets, resend_writes=self.write_retry)
+        else:
+            for writes in packets:
+                self._send_packet([], writes)
 
         if self.debug:
             for i, value in enumerate(datas):
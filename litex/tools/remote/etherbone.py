@@ -207,6 +207,7 @@ class EtherboneReads(Packet):
             else:
                 reads.append(EtherboneRead(unpack_uint64_from(v)[0]))
             offset += self.addr_size
+        self.base_ret_addr = base_ret_addr
         self.reads   = reads
         self.encoded = False
 
@@ -67,6 +67,7 @@ setup(
 
             # Demos.
             "litex_bare_metal_demo=litex.soc.software.demo.demo:main",
+            "litex_bare_metal_benchmark=litex.soc.software.benchmark.benchmark:main",
 
             # Export tools.
             "litex_json2dts_linux  = litex.tools.litex_json2dts_linux:main",
@@ -76,6 +77,7 @@ setup(
             # Development tools.
             "litex_read_verilog = litex.tools.litex_read_verilog:main",
             "litex_contributors = litex.tools.litex_contributors:main",
+            "litex_prof         = litex.tools.litex_prof:main",
         ],
     },
 )
@@ -7,15 +7,150 @@
 import unittest
 
 from migen import *
+from migen.fhdl.specials import Tristate
 
 from litex.soc.cores.bitbang import I2CMaster, SPIMaster
 
+# I2C Bus Model ------------------------------------------------------------------------------------
+
+class SimNoTristate:
+    # Pads are not simulated: the bus is modeled by I2CBusModel from the core's lines state.
+    @staticmethod
+    def lower(t):
+        return Module()
+
+class I2CBusModel:
+    """Open-drain I2C bus (pull-ups) with a slave driving SDA while SCL is low (no clock stretching).
+
+    role: "rx" (slave receives, ACKs when ``ack``), "tx" (slave transmits ``data``, stops on the
+    master NACK) or "idle".
+    """
+    def __init__(self):
+        self.role      = "idle"
+        self.ack       = True
+        self.data      = 0
+        self.bit       = 0
+        self.slave_low = 0
+        self.wave      = []
+
+    @passive
+    def generator(self, dut):
+        scl_prev, sda_prev = 1, 1
+        while True:
+            scl = (yield dut.scl)
+            sda = int(not ((yield dut.oe) and not (yield dut.sda)) and not self.slave_low)
+            yield dut._r.fields.sda.eq(sda)
+            self.wave.append((scl, sda))
+            # START: restart bit counting.
+            if scl and scl_prev and sda_prev and not sda:
+                self.bit = 0
+            # SCL rising: bit sampled (master NACK ends a slave transmission).
+            elif scl and not scl_prev:
+                if (self.role == "tx") and (self.bit == 8) and sda:
+                    self.role = "idle"
+                self.bit = (self.bit + 1) % 9
+            # SCL low: slave drives the next bit.
+            if not scl:
+                if self.role == "rx":
+                    self.slave_low = int((self.bit == 8) and self.ack)
+                elif self.role == "tx":
+                    self.slave_low = int((self.bit < 8) and not ((self.data >> (7 - self.bit)) & 1))
+                else:
+                    self.slave_low = 0
+            scl_prev, sda_prev = scl, sda
+            yield
+
+    def decode(self):
+        """Decode the waveform to START ("S"), STOP ("P") and bits, with (rise, fall) cycles of bits."""
+        events = []
+        bits   = []
+        rise   = None
+        cond   = False
+        for n, ((scl0, sda0), (scl1, sda1)) in enumerate(zip(self.wave, self.wave[1:])):
+            if scl0 and scl1 and (sda0 != sda1):
+                events.append("S" if sda0 else "P")
+                cond = True
+            elif not scl0 and scl1:
+                rise, cond = n + 1, False
+            elif scl0 and not scl1:
+                if (rise is not None) and not cond:
+                    events.append(sda0)
+                    bits.append((rise, n + 1))
+        return events, bits
+
 class TestBitBang(unittest.TestCase):
     def test_i2c_master_syntax(self):
         i2c_master = I2CMaster()
         self.assertEqual(hasattr(i2c_master, "pads"), 1)
         i2c_master = I2CMaster(Record(I2CMaster.pads_layout))
         self.assertEqual(hasattr(i2c_master, "pads"), 1)
+        i2c_master = I2CMaster(with_controller=True)
+        self.assertEqual(hasattr(i2c_master, "_cmd"), 1)
+
+    def test_i2c_master_controller(self):
+        clkdiv = 4
+        quarter = clkdiv + 1
+        START, WRITE, READ, ACK, STOP = [1 << n for n in range(8, 13)]
+        status = {}
+
+        def byte_bits(byte, ack):
+            return [(byte >> (7 - i)) & 1 for i in range(8)] + [0 if ack else 1]
+
+        def generator(dut, bus):
+            def cmd(name, value):
+                yield from dut._cmd.write(value)
+                yield
+                while (yield dut._status.fields.busy):
+                    yield
+                status[name] = ((yield dut._status.fields.data), (yield dut._status.fields.nack))
+
+            yield from dut._clkdiv.write(clkdiv)
+            # START + address write, ACKed.
+            bus.role, bus.ack = "rx", True
+            yield from cmd("addr_wr", START | WRITE | 0xa0)
+            # Byte write, NACKed.
+            bus.ack = False
+            yield from cmd("nack", WRITE | 0x55)
+            # Repeated START + address read, ACKed.
+            bus.ack = True
+            yield from cmd("addr_rd", START | WRITE | 0xa1)
+            # Byte reads, ACKed then NACKed by the master.
+            bus.role, bus.data = "tx", 0x3c
+            yield from cmd("read_ack", READ | ACK)
+            bus.data = 0xc3
+            yield from cmd("read_nack", READ)
+            # STOP.
+            yield from cmd("stop", STOP)
+            for i in range(4*quarter):
+                yield
+            self.assertEqual((yield dut.oe), 0)
+
+        dut = I2CMaster(with_controller=True)
+        bus = I2CBusModel()
+        run_simulation(dut, [generator(dut, bus), bus.generator(dut)],
+            special_overrides={Tristate: SimNoTristate})
+
+        # Status.
+        self.assertEqual(status["addr_wr"][1],   0)
+        self.assertEqual(status["nack"][1],      1)
+        self.assertEqual(status["addr_rd"][1],   0)
+        self.assertEqual(status["read_ack"][0],  0x3c)
+        self.assertEqual(status["read_nack"][0], 0xc3)
+
+        # Waveforms: conditions and bits (SDA stable while SCL high).
+        events, bits = bus.decode()
+        self.assertEqual(events,
+            ["S"] + byte_bits(0xa0, ack=True) + byte_bits(0x55, ack=False) +
+            ["S"] + byte_bits(0xa1, ack=True) + byte_bits(0x3c, ack=True) + byte_bits(0xc3, ack=False) +
+            ["P"])
+        self.assertEqual(bus.wave[-1], (1, 1))
+
+        # Timings: SCL high for 2 quarters, SCL period of 4 quarters within a byte.
+        for rise, fall in bits:
+            self.assertEqual(fall - rise, 2*quarter)
+        for i in range(0, len(bits), 9):
+            for (rise0, _), (rise1, _) in zip(bits[i:i+9], bits[i+1:i+9]):
+                self.assertEqual(rise1 - rise0, 4*quarter)
 
     def test_spi_master_syntax(self):
         spi_master = SPIMaster()
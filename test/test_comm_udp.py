@@ -0,0 +1,104 @@
+#
+# This file is part of LiteX.
+#
+# SPDX-License-Identifier: BSD-2-Clause
+
+import socket
+import unittest
+
+from litex.tools.remote.etherbone import EtherbonePacket, EtherboneRecord, EtherboneWrites
+from litex.tools.remote.comm_udp import CommUDP
+
+# Etherbone Server Model ---------------------------------------------------------------------------
+
+class EtherboneSocketModel:
+    """Socket replacement answering Etherbone packets from a memory, dropping the responses of the
+    first drop_responses packets (writes are still done)."""
+    def __init__(self, drop_responses=0):
+        self.mem            = {}
+        self.writes         = [] # (addr, data) in execution order.
+        self.packets        = 0
+        self.records        = [] # Records per packet.
+        self.drop_responses = drop_responses
+        self.responses      = []
+
+    def sendto(self, datas, addr):
+        self.packets += 1
+        packet = EtherbonePacket(32, datas)
+        packet.decode()
+        self.records.append(len(packet.records))
+        response = EtherbonePacket(32)
+        for record in packet.records:
+            if record.writes is not None:
+                for i, data in enumerate(record.writes.get_datas()):
+                    self.mem[record.writes.base_addr + 4*i] = data
+                    self.writes.append((record.writes.base_addr + 4*i, data))
+            if record.reads is not None:
+                reply = EtherboneRecord(addr_size=4)
+                reply.writes = EtherboneWrites(addr_size=4, base_addr=record.reads.base_ret_addr,
+                    datas=[self.mem.get(addr, 0) for addr in record.reads.get_addrs()])
+                reply.wcount = len(reply.writes)
+                response.records.append(reply)
+        if self.drop_responses:
+            self.drop_responses -= 1
+        elif response.records:
+            response.encode()
+            self.responses.append(response.bytes)
+
+    def recvfrom(self, size):
+        if not self.responses:
+            raise socket.timeout
+        return self.responses.pop(0), ("127.0.0.1", 1234)
+
+def comm_udp(drop_responses=0, **kwargs):
+    comm = CommUDP(**kwargs)
+    comm.socket = EtherboneSocketModel(drop_responses)
+    return comm
+
+# Test CommUDP -------------------------------------------------------------------------------------
+
+class TestCommUDP(unittest.TestCase):
+    def test_write_read(self):
+        comm  = comm_udp(max_burst=16, write_ack=True)
+        datas = list(range(100))
+        comm.write(0x1000, datas)
+        self.assertEqual(comm.read(0x1000, len(datas)), datas)
+        self.assertEqual(len(comm.socket.writes), len(datas))
+
+    def test_hardware_defaults(self):
+        # Defaults match the hardware Etherbone core: 16-word records, one record per packet.
+        comm = comm_udp()
+        comm.write(0x1000, list(range(40)))
+        self.assertEqual(comm.read(0x1000, 40), list(range(40)))
+        self.assertEqual(comm.socket.records, [1]*6)
+
+    def test_cpu_server_bursts(self):
+        # CPU servers: 255-word records, packed to the MTU.
+        comm = comm_udp(max_burst=255, max_records=None, write_ack=True)
+        comm.write(0x1000, list(range(600)))
+        self.assertEqual(comm.read(0x1000, 600), list(range(600)))
+        self.assertTrue(max(comm.socket.records) > 1)
+        self.assertTrue(comm.socket.packets < 600//16)
+
+    def test_write_empty(self):
+        for write_ack in [False, True]:
+            comm = comm_udp(write_ack=write_ack)
+            comm.write(0x1000, [])
+            self.assertEqual(comm.socket.packets, 0)
+
+    def test_write_ack_timeout_no_replay(self):
+        # Lost read-back: writes are not replayed, the timeout is reported.
+        comm = comm_udp(drop_responses=1, write_ack=True)
+        with self.assertRaises(socket.timeout):
+            comm.write(0x1000, [0x12345678])
+        self.assertEqual(comm.socket.writes, [(0x1000, 0x12345678)])
+
+    def test_write_ack_timeout_retry(self):
+        # Lost read-back with write_retry: the write packet is sent (and the write done) again.
+        comm = comm_udp(drop_responses=1, write_ack=True, write_retry=True)
+        comm.write(0x1000, [0x12345678])
+        self.assertEqual(comm.socket.writes, [(0x1000, 0x12345678)]*2)
+        self.assertEqual(comm.read(0x1000), 0x12345678)
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,70 @@
+#
+# This file is part of LiteX.
+#
+# SPDX-License-Identifier: BSD-2-Clause
+
+import random
+import unittest
+
+from migen import *
+
+from litex.gen import *
+
+from litex.soc.interconnect import wishbone
+from litex.soc.cores.dma import WishboneDMACopy
+
+# DUT ----------------------------------------------------------------------------------------------
+
+class DMACopyDUT(LiteXModule):
+    def __init__(self, init):
+        bus_r = wishbone.Interface()
+        bus_w = wishbone.Interface()
+        self.src = wishbone.SRAM(1024, init=init, bus=bus_r)
+        self.dst = wishbone.SRAM(1024, bus=bus_w)
+        self.dma = WishboneDMACopy(bus_r, bus_w, fifo_depth=4, with_irq=False)
+
+# TestDMA ------------------------------------------------------------------------------------------
+
+class TestDMA(unittest.TestCase):
+    def dma_copy_run(self, dut, src, dst, length, fill=0, value=0, timeout=4096):
+        yield from dut.dma._src.write(src)
+        yield from dut.dma._dst.write(dst)
+        yield from dut.dma._length.write(length)
+        yield from dut.dma._value.write(value)
+        yield from dut.dma._control.write(0b01 | (fill << 1))
+        yield
+        for i in range(timeout):
+            if (yield dut.dma.done):
+                return
+            yield
+        self.fail("DMA Copy timeout.")
+
+    def dma_copy_test(self, transfers):
+        prng = random.Random(42)
+        init = [prng.randrange(2**32) for _ in range(256)]
+        ref  = [0]*256
+
+        def generator(dut):
+            for src, dst, length, fill, value in transfers:
+                yield from self.dma_copy_run(dut, src, dst, length, fill, value)
+                for i in range(length//4):
+                    ref[dst//4 + i] = value if fill else init[src//4 + i]
+            for i in range(256):
+                self.assertEqual((yield dut.dst.mem[i]), ref[i])
+
+        dut = DMACopyDUT(init)
+        run_simulation(dut, generator(dut))
+
+    def test_dma_copy(self):
+        self.dma_copy_test([(0x040, 0x100, 0x80, 0, 0)])
+
+    def test_dma_fill(self):
+        self.dma_copy_test([(0x000, 0x010, 0x40, 1, 0x12345678)])
+
+    def test_dma_copy_sequence(self):
+        self.dma_copy_test([
+            (0x000, 0x000, 0x200, 0, 0),          # Copy.
+            (0x000, 0x080, 0x020, 1, 0xdeadbeef), # Fill over copy.
+            (0x000, 0x200, 0x000, 0, 0),          # Empty transfer (ignored).
+            (0x300, 0x3fc, 0x004, 0, 0),          # Single word.
+        ])
@@ -0,0 +1,59 @@
+#
+# This file is part of LiteX.
+#
+# SPDX-License-Identifier: BSD-2-Clause
+
+import unittest
+
+from litex.tools.remote.etherbone import EtherboneRecord, EtherboneReads, EtherboneWrites
+from litex.tools.litex_server import RemoteServer, RemoteRequest
+
+# Comm Model ---------------------------------------------------------------------------------------
+
+class CommModel:
+    """Memory backed comm link, failing on accesses to bad_addr."""
+    def __init__(self, bad_addr):
+        self.mem      = {}
+        self.bad_addr = bad_addr
+
+    def write(self, addr, datas):
+        for i, data in enumerate(datas):
+            if addr + 4*i == self.bad_addr:
+                raise IOError(f"Bus error @ 0x{self.bad_addr:08x}")
+            self.mem[addr + 4*i] = data
+
+    def read(self, addr, length=None, burst="incr"):
+        datas = []
+        for i in range(1 if length is None else length):
+            if addr + 4*i == self.bad_addr:
+                raise IOError(f"Bus error @ 0x{self.bad_addr:08x}")
+            datas.append(self.mem.get(addr + 4*i, 0))
+        return datas
+
+def request(writes=None, reads=None):
+    record = EtherboneRecord()
+    if writes is not None:
+        record.writes = EtherboneWrites(base_addr=writes[0], datas=writes[1])
+    if reads is not None:
+        record.reads = EtherboneReads(addrs=reads)
+    return RemoteRequest(record)
+
+# Test RemoteServer --------------------------------------------------------------------------------
+
+class TestRemoteServer(unittest.TestCase):
+    def test_execute_errors(self):
+        server = RemoteServer(CommModel(bad_addr=0x100), bind_ip="localhost")
+        requests = [
+            request(writes=(0x10, [1, 2])),          # Ok.
+            request(writes=(0x100, [3])),            # Write error.
+            request(reads=[0x10, 0x14]),             # Ok (merged with the next reads).
+            request(reads=[0xfc, 0x100]),            # Read error.
+            request(writes=(0x20, [4]), reads=[0x20]),
+        ]
+        server._execute(requests)
+        self.assertEqual([r.error is None for r in requests], [True, False, True, False, True])
+        self.assertEqual(requests[2].reads, [1, 2])
+        self.assertEqual(requests[4].reads, [4])
+
+if __name__ == "__main__":
+    unittest.main()
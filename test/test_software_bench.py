@@ -0,0 +1,128 @@
+#
+# This file is part of LiteX.
+#
+# SPDX-License-Identifier: BSD-2-Clause
+
+import os
+import re
+import json
+import zlib
+import random
+import shutil
+import struct
+import tempfile
+import unittest
+import subprocess
+
+bench_dir = os.path.join(os.path.dirname(__file__), "..", "litex", "soc", "software", "bench")
+
+def fat_dir_entries(name, index, cluster, size):
+    """Directory entries of a file: 8.3 entry preceded by the long file name entries when needed."""
+    base, _, ext = name.partition(".")
+    if name == name.upper() and len(base) <= 8 and len(ext) <= 3:
+        sfn = base.ljust(8) + ext.ljust(3)
+        lfn = b""
+    else:
+        sfn = (base.upper()[:6] + f"~{index}").ljust(8) + ext.upper()[:3].ljust(3)
+        checksum = 0
+        for c in sfn.encode():
+            checksum = (((checksum & 1) << 7) + (checksum >> 1) + c) & 0xff
+        chars = [ord(c) for c in name] + [0]
+        chars += [0xffff]*(-len(chars) % 13)
+        entries = []
+        for i in range(len(chars)//13):
+            c = chars[13*i:13*(i + 1)]
+            order = (i + 1) | (0x40 if i == len(chars)//13 - 1 else 0)
+            entries.append(struct.pack("<B5HBBB6HH2H", order, *c[0:5], 0x0f, 0, checksum, *c[5:11], 0, *c[11:13]))
+        lfn = b"".join(reversed(entries))
+    return lfn + struct.pack("<11sB10xHHHI", sfn.encode(), 0x20, 0, 0x21, cluster, size)
+
+def fat16_image(filename, files, fragment=0):
+    """Create a 32MiB FAT16 image with files (name: data) in the root directory.
+    With fragment, a free cluster is left every fragment clusters of the files."""
+    sectors, cluster_sectors, fat_sectors, root_entries = 65536, 4, 64, 512
+    root_sectors  = root_entries*32//512
+    data_sector   = 1 + 2*fat_sectors + root_sectors
+    cluster_bytes = cluster_sectors*512
+
+    # Boot sector.
+    boot = bytearray(512)
+    boot[0:3]   = b"\xeb\x3c\x90"
+    boot[3:11]  = b"MSWIN4.1"
+    struct.pack_into("<HBHBHHBHHHII", boot, 11, 512, cluster_sectors, 1, 2, root_entries, 0, 0xf8,
+        fat_sectors, 32, 64, 0, sectors)
+    struct.pack_into("<BBBI", boot, 36, 0x80, 0, 0x29, 0x12345678)
+    boot[43:54]  = b"LITEX      "
+    boot[54:62]  = b"FAT16   "
+    boot[510:512] = b"\x55\xaa"
+
+    # Allocate clusters.
+    fat     = [0xfff8, 0xffff]
+    root    = bytearray()
+    data    = {}
+    cluster = 2
+    for index, (name, content) in enumerate(files.items()):
+        nclusters = max(1, (len(content) + cluster_bytes - 1)//cluster_bytes)
+        chain = []
+        while len(chain) < nclusters:
+            if fragment and len(chain) and (len(chain) % fragment) == 0 and chain[-1] == cluster - 1:
+                fat.append(0)
+                cluster += 1
+            chain.append(cluster)
+            fat.append(0)
+            cluster += 1
+        for i, c in enumerate(chain):
+            fat[c] = chain[i + 1] if i + 1 < len(chain) else 0xffff
+            data[c] = content[i*cluster_bytes:(i + 1)*cluster_bytes]
+        root += fat_dir_entries(name, index + 1, chain[0], len(content))
+
+    with open(filename, "wb") as f:
+        f.truncate(sectors*512)
+        f.write(boot)
+        fat_data = struct.pack(f"<{len(fat)}H", *fat)
+        for i in range(2):
+            f.seek((1 + i*fat_sectors)*512)
+            f.write(fat_data)
+        f.seek((1 + 2*fat_sectors)*512)
+        f.write(root)
+        for c, content in data.items():
+            f.seek((data_sector + (c - 2)*cluster_sectors)*512)
+            f.write(content)
+
+class TestSoftwareBench(unittest.TestCase):
+    def setUp(self):
+        # Host build of the hardware-independent firmware routines (litex/soc/software/bench).
+        if shutil.which("gcc") is None or shutil.which("make") is None:
+            self.skipTest("Host gcc/make not available.")
+
+    def tearDown(self):
+        subprocess.run(["make", "-C", bench_dir, "clean"], capture_output=True)
+
+    def test_software_bench(self):
+        result = subprocess.run(["make", "-C", bench_dir, "check"], capture_output=True, text=True)
+        self.assertEqual(result.returncode, 0, result.stdout + result.stderr)
+        self.assertIn("All tests passed.", result.stdout)
+
+    def test_fatfs_bench(self):
+        prng  = random.Random(42)
+        files = {
+            "boot.json": json.dumps({
+                "Image"    : "0x40000000",
+                "rv32.dtb" : "0x40ef0000",
+                "bootargs" : {"r1": "0x40ef0000", "addr": "0x40000000"},
+            }).encode(),
+            "Image"    : bytes(prng.getrandbits(8) for _ in range(1024*1024 + 300)),
+            "rv32.dtb" : bytes(prng.getrandbits(8) for _ in range(5000)),
+        }
+        with tempfile.TemporaryDirectory() as tmp:
+            image = os.path.join(tmp, "sdcard.img")
+            fat16_image(image, files, fragment=64)
+            for args in ["", "-c 64"]:
+                result = subprocess.run(["make", "-C", bench_dir, "fatfs", f"IMAGE={image}", f"FATFS_ARGS={args}"],
+                    capture_output=True, text=True)
+                self.assertEqual(result.returncode, 0, result.stdout + result.stderr)
+                for name in ["Image", "rv32.dtb"]:
+                    self.assertIn(f"{name}: {len(files[name])} bytes, crc32 0x{zlib.crc32(files[name]):08x}", result.stdout)
+                m = re.search(r"Disk requests: (\d+) \((\d+) multi-sector", result.stdout)
+                self.assertIsNotNone(m)
+                self.assertGreater(int(m.group(2)), 0)